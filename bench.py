@@ -0,0 +1,151 @@
+"""
+Times engine calls through the `chess` Python module and sets them against the same calls
+timed natively by the `bench` executable (src/bench.cpp), over the same positions.
+The difference is what the pybind11 binding costs per call.
+
+Usage: python bench.py [path/to/bench] [--time MS]
+"""
+import subprocess
+import sys
+import time
+
+import chess
+
+BENCH = "./bench"
+TIME_MS = 200
+
+
+def ns_per_call(boards, body):
+    """Runs body(board) over every board until TIME_MS has passed.
+    body returns how many calls it made. Returns nanoseconds per call (NaN if it made none)."""
+    calls = 0
+    start = time.perf_counter_ns()
+    while True:
+        for b in boards:
+            calls += body(b)
+        if not calls:
+            return float("nan")
+        elapsed = time.perf_counter_ns() - start
+        if elapsed >= TIME_MS * 1_000_000:
+            return elapsed / calls
+
+
+def legal_moves_into_list(b):
+    b.board.getLegalMoves(b.move_list)
+    return 1
+
+
+def legal_moves(b):
+    b.board.getLegalMoves()
+    return 1
+
+
+def generator(name, piece_type):
+    """One call of the named get*Moves generator per piece of that type of the side to move."""
+    def body(b):
+        generate = getattr(b.board, name)
+        moves = b.move_list
+        squares = b.squares[piece_type]
+        for row, col in squares:
+            moves.clear()
+            generate(row, col, moves)
+        return len(squares)
+    return body
+
+
+GENERATORS = [("getPawnMoves", 1), ("getKnightMoves", 2), ("getBishopMoves", 3),
+              ("getRookMoves", 4), ("getQueenMoves", 5), ("getKingMoves", 6)]
+
+
+def feature_planes(b):
+    b.board.get_feature_planes()
+    return 1
+
+
+def attacked_squares(b):
+    by_white = not b.board.is_white_to_move()
+    for row in range(8):
+        for col in range(8):
+            b.board.isSquareAttacked(row, col, by_white)
+    return 64
+
+
+def make_and_undo(b):
+    for move in b.moves:
+        b.board.makeMove(move)
+        b.board.undoMove()
+    return len(b.moves)
+
+
+def undo_redo(b):
+    b.board.undoMove()
+    b.board.redoMove()
+    return 1
+
+
+def undo_redo_status(b):
+    b.board.undoMove()
+    b.board.redoMove()
+    b.board.get_game_status()
+    return 1
+
+
+class BenchBoard:
+    def __init__(self, fen):
+        self.board = chess.Board()
+        if not self.board.set_fen(fen):
+            raise ValueError("cannot parse FEN " + fen)
+        self.moves = self.board.getLegalMoves()
+        self.move_list = chess.MoveList()
+
+        # Squares of the side to move's pieces, by piece type
+        side = 1 if self.board.is_white_to_move() else -1
+        self.squares = [[] for _ in range(7)]
+        for row, pieces in enumerate(self.board.get_board_state()):
+            for col, piece in enumerate(pieces):
+                if piece * side > 0:
+                    self.squares[piece * side].append((row, col))
+
+
+def main():
+    global BENCH, TIME_MS
+    args = sys.argv[1:]
+    if "--time" in args:
+        i = args.index("--time")
+        TIME_MS = int(args[i + 1])
+        del args[i:i + 2]
+    if args:
+        BENCH = args[0]
+
+    # The positions and the native numbers both come from the executable, so the two sides
+    # always run over the same corpus
+    fens = subprocess.run([BENCH, "--fens"], capture_output=True, text=True, check=True).stdout
+    boards = [BenchBoard(line.split(" ", 1)[1]) for line in fens.splitlines()]
+    output = subprocess.run([BENCH, "--time", str(TIME_MS)], capture_output=True, text=True, check=True).stdout
+    native = {line.split()[0]: float(line.split()[1]) for line in output.splitlines()}
+
+    # The same calls as each native benchmark, through the module
+    python = {
+        "getLegalMoves(MoveList)": ns_per_call(boards, legal_moves_into_list),
+        "getLegalMoves(vector)": ns_per_call(boards, legal_moves),
+    }
+    for name, piece_type in GENERATORS:
+        python[name] = ns_per_call(boards, generator(name, piece_type))
+    python["isSquareAttacked"] = ns_per_call(boards, attacked_squares)
+    python["makeMove+undoMove"] = ns_per_call(boards, make_and_undo)
+    for b in boards:
+        b.board.makeMove(b.moves[0])
+    python["undoMove+redoMove"] = ns_per_call(boards, undo_redo)
+    python["getGameStatus"] = ns_per_call(boards, undo_redo_status) - python["undoMove+redoMove"]
+    python["getFeaturePlanes"] = ns_per_call(boards, feature_planes)
+
+    print("{:<24} {:>12} {:>12} {:>12}".format("call", "native ns", "python ns", "binding ns"))
+    for name, native_ns in native.items():
+        if name in python:
+            print("{:<24} {:>12.1f} {:>12.1f} {:>12.1f}".format(name, native_ns, python[name], python[name] - native_ns))
+        else:
+            print("{:<24} {:>12.1f} {:>12} {:>12}".format(name, native_ns, "-", "-"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+"""
+Compares a `chess_engine bench --json` result against a stored baseline.
+
+A different signature means move generation now behaves differently (a bug, or an intended
+change that needs a new baseline). The same signature with fewer nodes per second is a
+throughput regression. The search section has its own signature (nodes searched on one thread
+to a fixed depth or node budget), checked the same way when both files have it; its speed and multi-thread
+speedup are only reported.
+
+Signatures only mean something between runs with the same settings: perft depth, search depth,
+search node budget and search options. When those differ the runs are reported as not
+comparable instead.
+
+Usage: python bench_compare.py baseline.json current.json [--threshold PERCENT]
+Exit status: 0 if fine, 1 on a throughput regression, 2 if a signature changed,
+3 if the two runs used different settings, 64 if the arguments are wrong.
+"""
+import json
+import sys
+
+EXIT_USAGE = 64  # EX_USAGE from sysexits.h, apart from every comparison result
+
+
+def search_settings(result):
+    """What a run's search signature depends on, or None if it did not search.
+    Files from before the settings were recorded have only the depth."""
+    search = result.get("search")
+    if not search:
+        return None
+    settings = {"search depth": search["depth"], "search nodes limit": search.get("nodes_limit", 0)}
+    for name, value in search.get("options", {}).items():
+        settings["search option " + name] = value
+    return settings
+
+
+def settings_mismatches(baseline, current):
+    """(setting, baseline value, current value) for every setting the two runs differ in."""
+    mismatches = []
+    if baseline["depth"] != current["depth"]:
+        mismatches.append(("perft depth", baseline["depth"], current["depth"]))
+    before, after = search_settings(baseline), search_settings(current)
+    if before is not None and after is not None:
+        for name in sorted(set(before) | set(after)):
+            if before.get(name) != after.get(name):
+                mismatches.append((name, before.get(name), after.get(name)))
+    return mismatches
+
+
+def main():
+    args = sys.argv[1:]
+    threshold = 5.0
+    if "--threshold" in args:
+        i = args.index("--threshold")
+        try:
+            threshold = float(args[i + 1])
+        except (IndexError, ValueError):
+            args = []
+        del args[i:i + 2]
+    if len(args) != 2:
+        print(__doc__.strip())
+        return EXIT_USAGE
+
+    try:
+        with open(args[0]) as f:
+            baseline = json.load(f)
+        with open(args[1]) as f:
+            current = json.load(f)
+    except (OSError, ValueError) as e:
+        print("cannot read results: {}".format(e))
+        return EXIT_USAGE
+
+    mismatches = settings_mismatches(baseline, current)
+    if mismatches:
+        print("NOT COMPARABLE: the runs used different settings")
+        for name, before, after in mismatches:
+            print("  {}: {} -> {}".format(name, before, after))
+        return 3
+
+    if baseline["signature"] != current["signature"]:
+        print("SIGNATURE CHANGED: baseline {}, current {} at depth {}".format(
+            baseline["signature"], current["signature"], current["depth"]))
+        before = {p["name"]: p["nodes"] for p in baseline["positions"]}
+        for p in current["positions"]:
+            if before.get(p["name"]) != p["nodes"]:
+                print("  {}: {} -> {}".format(p["name"], before.get(p["name"]), p["nodes"]))
+        return 2
+
+    search, old_search = current.get("search"), baseline.get("search")
+    if search and old_search and search["signature"] != old_search["signature"]:
+        print("SEARCH SIGNATURE CHANGED: baseline {}, current {}".format(
+            old_search["signature"], search["signature"]))
+        return 2
+
+    change = (current["nps"] - baseline["nps"]) / baseline["nps"] * 100
+    print("Signature {} unchanged".format(current["signature"]))
+    print("Nodes/second: {:.0f} -> {:.0f} ({:+.1f}%)".format(baseline["nps"], current["nps"], change))
+    if search and old_search:
+        print("Search nodes/second: {:.0f} -> {:.0f}".format(old_search["nps"], search["nps"]))
+        if "average_depth" in search and "average_depth" in old_search:
+            print("Average depth reached: {:.2f} -> {:.2f}".format(old_search["average_depth"], search["average_depth"]))
+        if "branching" in search and "branching" in old_search:
+            print("Effective branching factor: {:.2f} -> {:.2f}".format(old_search["branching"], search["branching"]))
+    if search and "speedup" in search:
+        print("Search speedup with {} threads: {:.2f}".format(search["threads"], search["speedup"]))
+    if search and old_search and search.get("threads") != old_search.get("threads"):
+        print("(the runs used {} and {} threads, so their speedups are not comparable)".format(
+            old_search.get("threads"), search.get("threads")))
+    if change < -threshold:
+        print("REGRESSION: more than {:.1f}% slower".format(threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -251,6 +251,12 @@ def main():
             elif status == chess.GameStatus.DRAW_INSUFFICIENT_MATERIAL:
                 game_over = True
                 game_over_message = "Draw by Insufficient Material."
+            elif status == chess.GameStatus.DRAW_THREEFOLD_REPETITION:
+                game_over = True
+                game_over_message = "Draw by Threefold Repetition."
+            elif status == chess.GameStatus.DRAW_FIFTY_MOVE:
+                game_over = True
+                game_over_message = "Draw by the Fifty-Move Rule."
 
         for event in pygame.event.get():
             if event.type == pygame.QUIT:
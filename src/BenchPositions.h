@@ -0,0 +1,32 @@
+#ifndef BENCH_POSITIONS_H
+#define BENCH_POSITIONS_H
+
+// Fixed set of positions the benchmarks run over, so numbers from different builds and
+// machines compare like for like. Half middlegames (many pieces, castling, pins), half endgames
+struct BenchPosition
+{
+	const char *name;
+	const char *fen;
+};
+
+inline constexpr BenchPosition BENCH_POSITIONS[] = {
+	// Middlegames
+	{"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+	{"italian", "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4"},
+	{"giuoco-pianissimo", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"},
+	{"queens-gambit", "r2q1rk1/pp2bppp/2n1pn2/2pp4/3P4/2PBPN2/PP1N1PPP/R2QK2R w KQ - 0 9"},
+	{"hedgehog", "2rq1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PNBPN2/PB3PPP/2RQ1RK1 w - - 0 11"},
+	{"promotion-race", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"},
+
+	// Endgames
+	{"rook-vs-rook", "8/5pk1/6p1/8/3R4/6P1/5PK1/r7 w - - 0 40"},
+	{"pawns", "8/8/1p3k2/p1p5/P1P2K2/1P6/8/8 w - - 0 50"},
+	{"queen-vs-queen", "6k1/5ppp/8/8/8/8/q4PPP/3Q2K1 w - - 0 30"},
+	{"rook-and-pawns", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"},
+	{"bishop-vs-pawn", "8/8/4k3/8/2p5/8/B2K4/8 w - - 0 1"},
+	{"knights", "8/3k4/8/2n5/8/3NK3/8/8 b - - 0 60"},
+};
+
+inline constexpr int BENCH_POSITION_COUNT = sizeof(BENCH_POSITIONS) / sizeof(BENCH_POSITIONS[0]);
+
+#endif // BENCH_POSITIONS_H
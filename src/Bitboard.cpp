@@ -0,0 +1,236 @@
+#include "Bitboard.h"
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+Magic ROOK_MAGICS[64];
+Magic BISHOP_MAGICS[64];
+bool g_usePext = false;
+bool g_useAvx2 = false;
+Bitboard BETWEEN[64][64];
+Bitboard LINE[64][64];
+
+// Multipliers found offline for this square numbering (a8 = 0). Each one maps every
+// blocker subset of its square to a distinct slot, or to a slot with the same attacks
+static const Bitboard ROOK_MAGIC_NUMBERS[64] = {
+	0x0080068051E04000ULL, 0x0040001000402000ULL, 0x0080100020008008ULL, 0x4E000A0010208440ULL,
+	0x4200040802002010ULL, 0x0100010008020400ULL, 0x9080608019000600ULL, 0x8100020080204100ULL,
+	0x4103800480400020ULL, 0x8015004004802100ULL, 0x000200108A002040ULL, 0x0801000821001000ULL,
+	0x0015000500080070ULL, 0x0120800400800200ULL, 0x0109000432001100ULL, 0x020080055B000080ULL,
+	0x0080004000402002ULL, 0x5260848020004008ULL, 0x2402020014402080ULL, 0x3000808010000802ULL,
+	0x0304018004810800ULL, 0x0000808004000200ULL, 0x0002040001500248ULL, 0x0012020000408401ULL,
+	0x8440008080004020ULL, 0x0804200840100040ULL, 0x0820008080201000ULL, 0x2080100100082100ULL,
+	0x0001000500100800ULL, 0x00A1000900028400ULL, 0x0100100400C80102ULL, 0x000001120000A044ULL,
+	0x800080C004800620ULL, 0x4040081000202000ULL, 0x0D08802008801000ULL, 0x1000800800801004ULL,
+	0x1004000801010010ULL, 0x0402800400800200ULL, 0x0004080204008110ULL, 0x0000404082000401ULL,
+	0x00C0118861408000ULL, 0x1100220081020048ULL, 0x09A0430420050010ULL, 0x0000082200420010ULL,
+	0x2110080004008080ULL, 0x2004201040680104ULL, 0x1106001451820008ULL, 0x0002224104820014ULL,
+	0x00800C8044210500ULL, 0x02A0200040100040ULL, 0x040100A0001E4100ULL, 0x00204023108A0200ULL,
+	0x2400080080040080ULL, 0x1289008400020900ULL, 0x0002088250010400ULL, 0x0001006084010200ULL,
+	0x0001023480002141ULL, 0x0006400021810015ULL, 0x8400100840200101ULL, 0x40003000A1000825ULL,
+	0x1002011008200402ULL, 0x100D000400080201ULL, 0x0020048806102904ULL, 0x8401000020804201ULL};
+
+static const Bitboard BISHOP_MAGIC_NUMBERS[64] = {
+	0x4C40240122060016ULL, 0x8048110404004A80ULL, 0x8004440410414020ULL, 0x021C410060405000ULL,
+	0x80CD1040D0480812ULL, 0x0002021104000082ULL, 0x08440082A8200001ULL, 0x00202A0800841002ULL,
+	0x0200C40810842088ULL, 0x60C0081000C08901ULL, 0x00A3D0040042510CULL, 0x1C00110400808541ULL,
+	0x0400820211084005ULL, 0x0000008860080800ULL, 0x002002020202C000ULL, 0x0400344E08040A81ULL,
+	0x812800102098A080ULL, 0x00202010823A2040ULL, 0x4086400800830201ULL, 0x5008012A22004000ULL,
+	0x0004801C00A00000ULL, 0x0000400200505400ULL, 0x0480408401080820ULL, 0x8000400029082824ULL,
+	0x0008880804501000ULL, 0x0001600048084100ULL, 0x0108220624040400ULL, 0x0008080000820002ULL,
+	0xC804040010410041ULL, 0x01080A0040208400ULL, 0x2018030480A88800ULL, 0x4040410020410810ULL,
+	0x1108044010100210ULL, 0x084A100400029800ULL, 0x0801080100820C00ULL, 0x8010400808108200ULL,
+	0x0084008400020500ULL, 0x0002004200290481ULL, 0x0010150200032090ULL, 0x8404042220404102ULL,
+	0x0302080308004008ULL, 0x1200420820000408ULL, 0x0802002024200800ULL, 0x4020824208000084ULL,
+	0x000002020C008200ULL, 0x2C40208081000882ULL, 0x2082223441000401ULL, 0x8804080081101020ULL,
+	0x4401011002220808ULL, 0x81020C4202100000ULL, 0x4005004404040308ULL, 0x0820400C42020001ULL,
+	0x0020206421820010ULL, 0x0150401001424008ULL, 0x02A20242020C0608ULL, 0x5020110109011200ULL,
+	0x2050840108410401ULL, 0x0100090880842108ULL, 0x220008960142187AULL, 0x1111028880208820ULL,
+	0x4400200042028200ULL, 0x4400010802084206ULL, 0x0000400242040100ULL, 0x0002201104010944ULL};
+
+// One table for all squares. Sizes are the sum of 2^(mask bits) over the 64 squares
+static Bitboard RookTable[0x19000];
+static Bitboard BishopTable[0x1480];
+
+static const int ROOK_D_ROW[] = {-1, 1, 0, 0};
+static const int ROOK_D_COL[] = {0, 0, -1, 1};
+static const int BISHOP_D_ROW[] = {-1, -1, 1, 1};
+static const int BISHOP_D_COL[] = {-1, 1, -1, 1};
+
+// Walk each ray from sq until it leaves the board or hits a piece.
+// Only used to fill the tables
+static Bitboard slidingAttacks(int sq, Bitboard occupied, const int d_row[4], const int d_col[4])
+{
+	Bitboard attacks = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		int r = rowOf(sq) + d_row[i];
+		int c = colOf(sq) + d_col[i];
+		while (r >= 0 && r < 8 && c >= 0 && c < 8)
+		{
+			Bitboard b = squareBB(squareOf(r, c));
+			attacks |= b;
+			if (occupied & b)
+				break; // Blocked, but the blocker itself is attacked
+			r += d_row[i];
+			c += d_col[i];
+		}
+	}
+	return attacks;
+}
+
+static void initMagics(Magic magics[64], Bitboard table[], const Bitboard magicNumbers[64],
+					   const int d_row[4], const int d_col[4])
+{
+	Bitboard *next = table;
+	for (int sq = 0; sq < 64; ++sq)
+	{
+		// A piece on the last square of a ray never blocks anything, so the edges
+		// (other than the ones the square itself sits on) are left out of the mask
+		Bitboard edges = ((ROW_0 | ROW_7) & ~(ROW_0 << (8 * rowOf(sq)))) |
+						 ((COL_A | COL_H) & ~(COL_A << colOf(sq)));
+
+		Magic &m = magics[sq];
+		m.mask = slidingAttacks(sq, 0, d_row, d_col) & ~edges;
+		m.magic = magicNumbers[sq];
+		m.shift = 64 - popCount(m.mask);
+		m.attacks = next;
+
+		// Visit every subset of the mask (carry-rippler trick) and store its attacks
+		Bitboard subset = 0;
+		do
+		{
+			m.attacks[m.index(subset)] = slidingAttacks(sq, subset, d_row, d_col);
+			subset = (subset - m.mask) & m.mask;
+		} while (subset);
+
+		next += 1ULL << popCount(m.mask);
+	}
+}
+
+static void initLines()
+{
+	for (int a = 0; a < 64; ++a)
+	{
+		for (int b = 0; b < 64; ++b)
+		{
+			BETWEEN[a][b] = LINE[a][b] = 0;
+			for (int rook = 0; rook < 2; ++rook)
+			{
+				const int *d_row = rook ? ROOK_D_ROW : BISHOP_D_ROW;
+				const int *d_col = rook ? ROOK_D_COL : BISHOP_D_COL;
+				if (a != b && (slidingAttacks(a, 0, d_row, d_col) & squareBB(b)))
+				{
+					// Each square sees the other, so their rays meet exactly on the squares between
+					BETWEEN[a][b] = slidingAttacks(a, squareBB(b), d_row, d_col) &
+									slidingAttacks(b, squareBB(a), d_row, d_col);
+					LINE[a][b] = (slidingAttacks(a, 0, d_row, d_col) & slidingAttacks(b, 0, d_row, d_col)) |
+								 squareBB(a) | squareBB(b);
+				}
+			}
+		}
+	}
+}
+
+// Shift left for a positive amount, right for a negative one
+template <int Shift>
+static inline Bitboard shiftBy(Bitboard b)
+{
+	return Shift > 0 ? b << Shift : b >> -Shift;
+}
+
+// Kogge-Stone fill in one direction: every generator slides until it reaches an occupied
+// square, doubling the distance covered each step. `notWrap` drops squares a step would
+// reach by wrapping around the board edge. Returns the squares attacked in that direction
+template <int Shift>
+static inline Bitboard fillAttacks(Bitboard gen, Bitboard empty, Bitboard notWrap)
+{
+	Bitboard pro = empty & notWrap;
+	gen |= pro & shiftBy<Shift>(gen);
+	pro &= shiftBy<Shift>(pro);
+	gen |= pro & shiftBy<2 * Shift>(gen);
+	pro &= shiftBy<2 * Shift>(pro);
+	gen |= pro & shiftBy<4 * Shift>(gen);
+	return shiftBy<Shift>(gen) & notWrap;
+}
+
+static Bitboard slidingAttacksScalar(Bitboard rooks, Bitboard bishops, Bitboard occupied)
+{
+	Bitboard empty = ~occupied;
+	return fillAttacks<-8>(rooks, empty, ~0ULL) |		// North
+		   fillAttacks<8>(rooks, empty, ~0ULL) |		// South
+		   fillAttacks<1>(rooks, empty, ~COL_A) |		// East
+		   fillAttacks<-1>(rooks, empty, ~COL_H) |		// West
+		   fillAttacks<-7>(bishops, empty, ~COL_A) |	// North-east
+		   fillAttacks<-9>(bishops, empty, ~COL_H) |	// North-west
+		   fillAttacks<9>(bishops, empty, ~COL_A) |		// South-east
+		   fillAttacks<7>(bishops, empty, ~COL_H);		// South-west
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+// The same fills with four directions per 256-bit register: one register for the four
+// directions that shift left (towards h1) and one for the four that shift right
+__attribute__((target("avx2"))) static Bitboard slidingAttacksAvx2(Bitboard rooks, Bitboard bishops, Bitboard occupied)
+{
+	// Lanes from low to high: rook south / east, bishop south-east / south-west,
+	// and rook north / west, bishop north-east / north-west
+	const __m256i shifts = _mm256_set_epi64x(7, 9, 1, 8);
+	const __m256i shiftsRight = _mm256_set_epi64x(9, 7, 1, 8);
+	const __m256i notWrapLeft = _mm256_set_epi64x(~COL_H, ~COL_A, ~COL_A, ~0ULL);
+	const __m256i notWrapRight = _mm256_set_epi64x(~COL_H, ~COL_A, ~COL_H, ~0ULL);
+	const __m256i empty = _mm256_set1_epi64x(~occupied);
+
+	__m256i genL = _mm256_set_epi64x(bishops, bishops, rooks, rooks);
+	__m256i genR = genL;
+	__m256i proL = _mm256_and_si256(empty, notWrapLeft);
+	__m256i proR = _mm256_and_si256(empty, notWrapRight);
+	__m256i sL = shifts;
+	__m256i sR = shiftsRight;
+	for (int i = 0; i < 3; ++i)
+	{
+		genL = _mm256_or_si256(genL, _mm256_and_si256(proL, _mm256_sllv_epi64(genL, sL)));
+		genR = _mm256_or_si256(genR, _mm256_and_si256(proR, _mm256_srlv_epi64(genR, sR)));
+		proL = _mm256_and_si256(proL, _mm256_sllv_epi64(proL, sL));
+		proR = _mm256_and_si256(proR, _mm256_srlv_epi64(proR, sR));
+		sL = _mm256_add_epi64(sL, sL);
+		sR = _mm256_add_epi64(sR, sR);
+	}
+	__m256i attacks = _mm256_or_si256(_mm256_and_si256(_mm256_sllv_epi64(genL, shifts), notWrapLeft),
+									  _mm256_and_si256(_mm256_srlv_epi64(genR, shiftsRight), notWrapRight));
+
+	// OR the four lanes together
+	__m128i half = _mm_or_si128(_mm256_castsi256_si128(attacks), _mm256_extracti128_si256(attacks, 1));
+	return Bitboard(_mm_cvtsi128_si64(half)) | Bitboard(_mm_extract_epi64(half, 1));
+}
+#endif
+
+Bitboard slidingAttacksBB(Bitboard rooks, Bitboard bishops, Bitboard occupied)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+	if (g_useAvx2)
+		return slidingAttacksAvx2(rooks, bishops, occupied);
+#endif
+	return slidingAttacksScalar(rooks, bishops, occupied);
+}
+
+static bool initTables()
+{
+#if defined(__BMI2__)
+	g_usePext = true;
+#elif defined(__x86_64__) && defined(__GNUC__)
+	__builtin_cpu_init();
+	g_usePext = __builtin_cpu_supports("bmi2");
+#endif
+#if defined(__AVX2__)
+	g_useAvx2 = true;
+#elif defined(__x86_64__) && defined(__GNUC__)
+	g_useAvx2 = __builtin_cpu_supports("avx2");
+#endif
+	initMagics(ROOK_MAGICS, RookTable, ROOK_MAGIC_NUMBERS, ROOK_D_ROW, ROOK_D_COL);
+	initMagics(BISHOP_MAGICS, BishopTable, BISHOP_MAGIC_NUMBERS, BISHOP_D_ROW, BISHOP_D_COL);
+	initLines();
+	return true;
+}
+
+// Filled once when the program or Python module is loaded
+static const bool s_tablesReady = initTables();
@@ -0,0 +1,174 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// A set of squares, one bit per square.
+// Squares are numbered row * 8 + col using the same (row, col) as the rest of the engine,
+// so bit 0 is a8 (row 0, col 0) and bit 63 is h1 (row 7, col 7)
+typedef uint64_t Bitboard;
+
+enum Color
+{
+	WHITE = 0,
+	BLACK = 1
+};
+
+constexpr Bitboard COL_A = 0x0101010101010101ULL;
+constexpr Bitboard COL_H = COL_A << 7;
+constexpr Bitboard ROW_0 = 0xFFULL; // Rank 8
+constexpr Bitboard ROW_7 = ROW_0 << 56; // Rank 1
+constexpr Bitboard LIGHT_SQUARES = 0xAA55AA55AA55AA55ULL; // (row + col) is odd
+
+constexpr int squareOf(int row, int col) { return row * 8 + col; }
+constexpr int rowOf(int sq) { return sq >> 3; }
+constexpr int colOf(int sq) { return sq & 7; }
+constexpr Bitboard squareBB(int sq) { return 1ULL << sq; }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+
+// Index of the lowest set bit. b must not be empty
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+
+// Return the lowest set square and clear it from b
+inline int popLsb(Bitboard &b)
+{
+	int sq = lsb(b);
+	b &= b - 1;
+	return sq;
+}
+
+// Shift every square of a set one step.
+// North is towards row 0 (the way White's pawns move), east is towards col 7
+constexpr Bitboard shiftNorth(Bitboard b) { return b >> 8; }
+constexpr Bitboard shiftSouth(Bitboard b) { return b << 8; }
+constexpr Bitboard shiftEast(Bitboard b) { return (b << 1) & ~COL_A; }
+constexpr Bitboard shiftWest(Bitboard b) { return (b >> 1) & ~COL_H; }
+
+// Squares attacked by every pawn in the set
+constexpr Bitboard pawnAttacksBB(Color c, Bitboard pawns)
+{
+	return c == WHITE ? shiftEast(shiftNorth(pawns)) | shiftWest(shiftNorth(pawns))
+					  : shiftEast(shiftSouth(pawns)) | shiftWest(shiftSouth(pawns));
+}
+
+constexpr Bitboard knightAttacksBB(Bitboard b)
+{
+	Bitboard east = shiftEast(b);
+	Bitboard west = shiftWest(b);
+	Bitboard attacks = (east | west) << 16 | (east | west) >> 16;
+	east = shiftEast(east);
+	west = shiftWest(west);
+	return attacks | (east | west) << 8 | (east | west) >> 8;
+}
+
+constexpr Bitboard kingAttacksBB(Bitboard b)
+{
+	Bitboard row = b | shiftEast(b) | shiftWest(b);
+	return (row | shiftNorth(row) | shiftSouth(row)) & ~b;
+}
+
+// Attack tables for the non-sliding pieces, built by the compiler so they cost nothing at load time
+struct LeaperTable
+{
+	Bitboard attacks[64];
+
+	template <typename Fn>
+	constexpr LeaperTable(Fn fn) : attacks{}
+	{
+		for (int sq = 0; sq < 64; ++sq)
+			attacks[sq] = fn(squareBB(sq));
+	}
+};
+
+inline constexpr LeaperTable KNIGHT_ATTACKS([](Bitboard b) { return knightAttacksBB(b); });
+inline constexpr LeaperTable KING_ATTACKS([](Bitboard b) { return kingAttacksBB(b); });
+inline constexpr LeaperTable PAWN_ATTACKS[2] = {
+	LeaperTable([](Bitboard b) { return pawnAttacksBB(WHITE, b); }),
+	LeaperTable([](Bitboard b) { return pawnAttacksBB(BLACK, b); })};
+
+inline Bitboard pawnAttacks(Color c, int sq) { return PAWN_ATTACKS[c].attacks[sq]; }
+inline Bitboard knightAttacks(int sq) { return KNIGHT_ATTACKS.attacks[sq]; }
+inline Bitboard kingAttacks(int sq) { return KING_ATTACKS.attacks[sq]; }
+
+// Sliding pieces use magic bitboards: the blockers on a square's rays are hashed into
+// a per-square slice of one shared attack table. On CPUs with BMI2 the hash is replaced by
+// PEXT, which packs the blocker bits directly into an index. The choice is made once at load
+// time (see Bitboard.cpp) and the tables are filled for whichever indexing is in use
+struct Magic
+{
+	Bitboard mask;	   // Squares whose occupancy matters (the rays without the board edge)
+	Bitboard magic;	   // Multiplier for the magic hash
+	Bitboard *attacks; // This square's slice of the attack table
+	int shift;		   // 64 - number of bits in mask
+
+	unsigned index(Bitboard occupied) const;
+};
+
+extern Magic ROOK_MAGICS[64];
+extern Magic BISHOP_MAGICS[64];
+
+// True if slider lookups use PEXT rather than the magic multiply
+extern bool g_usePext;
+
+// True if slidingAttacksBB runs its eight directions four at a time with AVX2
+extern bool g_useAvx2;
+
+// PEXT through inline assembly, so the instruction can be used behind the runtime check
+// without building the whole engine for BMI2
+inline Bitboard pext(Bitboard b, Bitboard mask)
+{
+#if defined(__BMI2__)
+	return _pext_u64(b, mask);
+#elif defined(__x86_64__) && defined(__GNUC__)
+	Bitboard result;
+	asm("pextq %2, %1, %0" : "=r"(result) : "r"(b), "r"(mask));
+	return result;
+#else
+	(void)b;
+	(void)mask;
+	return 0; // Never called: g_usePext stays false off x86-64
+#endif
+}
+
+inline unsigned Magic::index(Bitboard occupied) const
+{
+#if defined(__BMI2__)
+	return unsigned(pext(occupied, mask));
+#else
+	if (g_usePext)
+		return unsigned(pext(occupied, mask));
+	return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+}
+
+// Sliding attacks from sq, stopping at (and including) the first occupied square on each ray
+inline Bitboard rookAttacks(int sq, Bitboard occupied)
+{
+	const Magic &m = ROOK_MAGICS[sq];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied)
+{
+	const Magic &m = BISHOP_MAGICS[sq];
+	return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) { return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied); }
+
+// Every square attacked by a whole set of rook movers and a set of bishop movers (queens go
+// in both), found by flooding all of them along each direction at once (Kogge-Stone fills)
+// instead of looking up one piece at a time. Meant for whole-side attack maps
+Bitboard slidingAttacksBB(Bitboard rooks, Bitboard bishops, Bitboard occupied);
+
+// Squares strictly between two squares on a shared row, column or diagonal (empty if not aligned)
+extern Bitboard BETWEEN[64][64];
+
+// The whole row, column or diagonal through two squares, edge to edge (empty if not aligned)
+extern Bitboard LINE[64][64];
+
+#endif // BITBOARD_H
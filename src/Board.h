@@ -2,28 +2,10 @@
 #define BOARD_H
 
 #include <vector> // To hold a list of moves
-#include <utility>
-
-// Use simple integer to represent pieces (for now)
-// Positive = White, Negative = Black
-// 0 = Empty, 1 = Pawn, 2 = Knight, 3 = Bishop, 4 = Rook, 5 = Queen, 6 = King
-
-enum Piece
-{
-	EMPTY = 0,
-	W_PAWN = 1,
-	W_KNIGHT = 2,
-	W_BISHOP = 3,
-	W_ROOK = 4,
-	W_QUEEN = 5,
-	W_KING = 6,
-	B_PAWN = -1,
-	B_KNIGHT = -2,
-	B_BISHOP = -3,
-	B_ROOK = -4,
-	B_QUEEN = -5,
-	B_KING = -6
-};
+#include <cstdint>
+#include <memory>
+#include "Position.h"
+#include "Search.h"
 
 enum GameStatus
 {
@@ -31,150 +13,140 @@ enum GameStatus
 	WHITE_WINS_CHECKMATE = 1,
 	BLACK_WINS_CHECKMATE = 2,
 	DRAW_STALEMATE = 3,
-	DRAW_INSUFFICIENT_MATERIAL = 4
+	DRAW_INSUFFICIENT_MATERIAL = 4,
+	DRAW_THREEFOLD_REPETITION = 5,
+	DRAW_FIFTY_MOVE = 6
 };
 
-// A simple structure to hold move data
-struct Move
+// One ply of history: the move played and what it destroyed (see UndoInfo).
+// Laid out by hand to fit in 16 bytes, against ~200 for a full snapshot of the game
+struct PlyRecord
 {
-	int from_row;
-	int from_col;
-	int to_row;
-	int to_col;
-	int promotion_piece;
-
-	// Constructor for Normal moves
-	Move(int fr, int fc, int tr, int tc) : from_row(fr), from_col(fc), to_row(tr), to_col(tc), promotion_piece(EMPTY) {}
-
-	Move(int fr, int fc, int tr, int tc, int pp) : from_row(fr), from_col(fc), to_row(tr), to_col(tc), promotion_piece(pp) {}
+	uint64_t key;
+	Move move;
+	int8_t captured;
+	uint8_t castlingRights;
+	int8_t enPassantSquare;
+	uint16_t halfmoveClock;
+
+	UndoInfo undo() const { return {captured, castlingRights, enPassantSquare, halfmoveClock, key}; }
 };
 
-struct GameState
-{
-	int board[8][8];
-	bool whiteToMove;
-	std::pair<int, int> enPassantTarget;
-	bool canWhiteKingSide;
-	bool canWhiteQueenSide;
-	bool canBlackKingSide;
-	bool canBlackQueenSide;
-	std::vector<int> whiteCaptured;
-	std::vector<int> blackCaptured;
-
-	// Add a default constructor
-	GameState()
-	{
-		for (int r = 0; r < 8; ++r)
-		{
-			for (int c = 0; c < 8; ++c)
-			{
-				board[r][c] = EMPTY;
-			}
-		}
-		whiteToMove = true;
-		enPassantTarget = {-1, -1};
-		canWhiteKingSide = canWhiteQueenSide = canBlackKingSide = canBlackQueenSide = true;
-		whiteCaptured.clear();
-		blackCaptured.clear();
-	}
-};
+static_assert(sizeof(PlyRecord) == 16, "PlyRecord should stay 16 bytes");
 
-class Board
+// The game so far, kept apart from the position so that copying a Position never copies it.
+// One record per move of the current line. Moves that were undone stay in the list past the
+// current ply until a new move replaces them, which is what makes redo possible
+class GameHistory
 {
 public:
-	// Constructor:
-	Board();
+	GameHistory() : m_ply(0) {}
 
-	// Print the board to the console
-	void print();
+	// Record a move just played at the current ply. Anything that could have been redone is dropped
+	void push(const Move &move, const UndoInfo &undo);
 
-	// Function to update the board state with a move.
-	// We pass the Move object by const reference (&). This avoids making a copy
-	// and is more efficient
-	void makeMove(const Move &move);
+	// The last move played, moving back one ply. Only call when ply() > 0
+	const PlyRecord &stepBack() { return m_records[--m_ply]; }
 
-	// A function to get all legal moves for a pawn at a specific square
-	// Will return a vector of Move objects
-	std::vector<Move> getPawnMoves(int row, int col);
+	// The next move to redo, moving forward one ply. Only call when ply() < length()
+	const PlyRecord &stepForward() { return m_records[m_ply++]; }
 
-	// Knight's move generator
-	std::vector<Move> getKnightMoves(int row, int col);
+	// Moves played from the start to the current position
+	int ply() const { return m_ply; }
 
-	// Rook's move generator
-	std::vector<Move> getRookMoves(int row, int col);
+	// Zobrist key of the position after `ply` moves (0 <= ply < length()). The records double as
+	// the stack of earlier keys that repetitions are looked up in
+	uint64_t keyAt(int ply) const { return m_records[ply].key; }
 
-	// Bishop's move generator
-	std::vector<Move> getBishopMoves(int row, int col);
+	// Moves in the line, including those undone and not yet replaced
+	int length() const { return int(m_records.size()); }
 
-	// Queen's move generator
-	std::vector<Move> getQueenMoves(int row, int col);
+private:
+	std::vector<PlyRecord> m_records;
+	int m_ply;
+};
 
-	// King's move generator
-	std::vector<Move> getKingMoves(int row, int col);
+// A game: the current Position plus the captured pieces and the undo/redo history
+class Board : public Position
+{
+public:
+	// Constructor:
+	Board();
 
-	// Master function to get all moves for the current player
-	std::vector<Move> getLegalMoves();
+	// A new game starting from this one's position, with the same captured pieces and no history.
+	// Cheap, since only the fixed-size part is copied; the transposition table is shared, not copied
+	Board clone() const;
 
-	// Checks if a square is attacked by a given side
-	bool isSquareAttacked(int row, int col, bool byWhite);
+	// Start a new game from a FEN string: no captured pieces and no history.
+	// Returns false (leaving the game as it was) if Position::setFen rejects the string
+	bool setFen(const std::string &fen);
 
-	// Check the current king's status
-	// We pass 'true' to check the white king, 'false' for black
-	bool isKingInCheck(bool whiteKing);
+	// Position's in-place makeMove(move, undo) stays available. It does not touch the history
+	// (nor does makeNullMove), so it must be paired with unmakeMove(move, undo) rather than undoMove()
+	using Position::makeMove;
 
-	// A function to get the board state as a 2D vector
-	std::vector<std::vector<int>> getBoardState();
+	// Function to update the board state with a move.
+	// We pass the Move object by const reference (&). This avoids making a copy
+	// and is more efficient
+	void makeMove(const Move &move);
 
-	// Function to say whose turn it is
-	bool isWhiteToMove();
+	// Checked version of makeMove for moves from outside (the GUI, a network client).
+	// Plays the move and returns true if it is legal, otherwise leaves the board alone and returns false
+	bool tryMakeMove(const Move &move);
 
-	// Function to check game state
+	// Function to check game state.
+	// Worked out once per position and cached until the next move, undo or redo
 	GameStatus getGameStatus();
 
+	// How many times the current position occurred earlier in the game (2 means threefold repetition)
+	int getRepetitionCount() const;
+
+	// Both take back or replay a single move in place, in constant time
 	bool undoMove();
 	bool redoMove();
 
+	// Undo or redo as many moves as needed to stand after `ply` moves of the game line.
+	// Returns false (and does nothing) if the line has no such ply
+	bool goToPly(int ply);
+
+	// Moves played to reach the current position, and moves in the whole line (which is
+	// longer after an undo, until a new move is played)
+	int getPly() const { return m_history.ply(); }
+	int getHistoryLength() const { return m_history.length(); }
+
+	// Best move for the side to move, searched within `limits` (see Search.h). The board itself
+	// is not changed. The game so far is passed on so that the search sees repetitions, and the
+	// transposition table is kept from one call to the next (copies of a Board share it)
+	SearchResult search(const SearchLimits &limits);
+
+	// What search() hands the Search, for callers that take a snapshot of the board and search
+	// without it (the Python binding, which only lets go of the GIL for the search itself):
+	// the Zobrist keys of the game before the current position, oldest first, and the
+	// transposition table, created here on first use
+	std::vector<uint64_t> gameKeys() const;
+	std::shared_ptr<TranspositionTable> table();
+	// Search with `table` from now on. The default table is 16 MB, allocated and zeroed on the
+	// first search, so boards that search should share one (several searches may use a table at once)
+	void setTable(std::shared_ptr<TranspositionTable> table) { m_table = std::move(table); }
+
+	// Captured pieces of each color, sorted by piece value (the counters expanded into a list)
 	std::vector<int> getWhiteCaptured();
 	std::vector<int> getBlackCaptured();
 
-    // Return the board state as feature planes for RL
-    std::vector<std::vector<std::vector<int>>> getFeaturePlanes();
-
 private:
-	// Helper function to get the character for a piece
-	char getPieceChar(int piece);
-
-	// 8x8 array representing the board
-	int m_board[8][8];
-
-	// A variable to track whose turn it is
-	bool m_whiteToMove;
-
-	// Helper to find the specified king (specified by `bool whiteKing`)
-	std::pair<int, int> findKing(bool whiteKing);
-
-	// Store the (row, col) of the square that is vulerable to en passant. (-1, -) if none.
-	std::pair<int, int> m_enPassantTarget;
-
-	// Castling rights
-	bool m_canWhiteKingSide;
-	bool m_canWhiteQueenSide;
-	bool m_canBlackKingSide;
-	bool m_canBlackQueenSide;
+	// How many of each piece have been captured, indexed by piece + 6
+	uint8_t m_captured[13];
 
-	// Helper for draw detection
-	bool checkInsufficientMaterial();
+	GameHistory m_history;
 
-	// Lists for captured pieces
-	std::vector<int> m_whiteCaptured;
-	std::vector<int> m_blackCaptured;
+	// Created on the first search unless set, and shared with clones
+	std::shared_ptr<TranspositionTable> m_table;
 
-	// Stacks to hold game history
-	std::vector<GameState> m_history;
-	std::vector<GameState> m_redoStack;
+	// Cached result of getGameStatus, valid while m_statusCached is set and the key still matches
+	GameStatus m_status;
+	uint64_t m_statusKey;
+	bool m_statusCached;
 
-	// Helper functions to save/load state
-	void saveState(GameState &state);
-	void restoreState(const GameState &state);
+	GameStatus computeGameStatus();
 };
 #endif // BOARD_H
@@ -0,0 +1,108 @@
+#include "Evaluate.h"
+
+// Piece-square tables from White's side, in our square order (a8 = 0, h1 = 63).
+// Black looks them up with the rank flipped (sq ^ 56)
+static const int PAWN_TABLE[64] = {
+	0, 0, 0, 0, 0, 0, 0, 0,
+	50, 50, 50, 50, 50, 50, 50, 50,
+	10, 10, 20, 30, 30, 20, 10, 10,
+	5, 5, 10, 25, 25, 10, 5, 5,
+	0, 0, 0, 20, 20, 0, 0, 0,
+	5, -5, -10, 0, 0, -10, -5, 5,
+	5, 10, 10, -20, -20, 10, 10, 5,
+	0, 0, 0, 0, 0, 0, 0, 0};
+
+static const int KNIGHT_TABLE[64] = {
+	-50, -40, -30, -30, -30, -30, -40, -50,
+	-40, -20, 0, 0, 0, 0, -20, -40,
+	-30, 0, 10, 15, 15, 10, 0, -30,
+	-30, 5, 15, 20, 20, 15, 5, -30,
+	-30, 0, 15, 20, 20, 15, 0, -30,
+	-30, 5, 10, 15, 15, 10, 5, -30,
+	-40, -20, 0, 5, 5, 0, -20, -40,
+	-50, -40, -30, -30, -30, -30, -40, -50};
+
+static const int BISHOP_TABLE[64] = {
+	-20, -10, -10, -10, -10, -10, -10, -20,
+	-10, 0, 0, 0, 0, 0, 0, -10,
+	-10, 0, 5, 10, 10, 5, 0, -10,
+	-10, 5, 5, 10, 10, 5, 5, -10,
+	-10, 0, 10, 10, 10, 10, 0, -10,
+	-10, 10, 10, 10, 10, 10, 10, -10,
+	-10, 5, 0, 0, 0, 0, 5, -10,
+	-20, -10, -10, -10, -10, -10, -10, -20};
+
+static const int ROOK_TABLE[64] = {
+	0, 0, 0, 0, 0, 0, 0, 0,
+	5, 10, 10, 10, 10, 10, 10, 5,
+	-5, 0, 0, 0, 0, 0, 0, -5,
+	-5, 0, 0, 0, 0, 0, 0, -5,
+	-5, 0, 0, 0, 0, 0, 0, -5,
+	-5, 0, 0, 0, 0, 0, 0, -5,
+	-5, 0, 0, 0, 0, 0, 0, -5,
+	0, 0, 0, 5, 5, 0, 0, 0};
+
+static const int QUEEN_TABLE[64] = {
+	-20, -10, -10, -5, -5, -10, -10, -20,
+	-10, 0, 0, 0, 0, 0, 0, -10,
+	-10, 0, 5, 5, 5, 5, 0, -10,
+	-5, 0, 5, 5, 5, 5, 0, -5,
+	0, 0, 5, 5, 5, 5, 0, -5,
+	-10, 5, 5, 5, 5, 5, 0, -10,
+	-10, 0, 5, 0, 0, 0, 0, -10,
+	-20, -10, -10, -5, -5, -10, -10, -20};
+
+static const int KING_MIDDLEGAME_TABLE[64] = {
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-20, -30, -30, -40, -40, -30, -30, -20,
+	-10, -20, -20, -20, -20, -20, -20, -10,
+	20, 20, 0, 0, 0, 0, 20, 20,
+	20, 30, 10, 0, 0, 10, 30, 20};
+
+static const int KING_ENDGAME_TABLE[64] = {
+	-50, -40, -30, -20, -20, -30, -40, -50,
+	-30, -20, -10, 0, 0, -10, -20, -30,
+	-30, -10, 20, 30, 30, 20, -10, -30,
+	-30, -10, 30, 40, 40, 30, -10, -30,
+	-30, -10, 30, 40, 40, 30, -10, -30,
+	-30, -10, 20, 30, 30, 20, -10, -30,
+	-30, -30, 0, 0, 0, 0, -30, -30,
+	-50, -30, -30, -30, -30, -30, -30, -50};
+
+// Indexed by unsigned piece type; the king entry is picked per position
+static const int *const PIECE_TABLES[7] = {nullptr, PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, nullptr};
+
+// Non-pawn material per side at or below which the king should come out
+static const int ENDGAME_MATERIAL = PIECE_VALUE[W_ROOK] + PIECE_VALUE[W_BISHOP];
+
+// Material and piece-square score of one side
+template <Color Us>
+static int evaluateSide(const Position &pos, bool endgame)
+{
+	constexpr int FLIP = Us == WHITE ? 0 : 56;
+	int score = pos.getMaterial(Us == WHITE);
+
+	for (int type = W_PAWN; type <= W_QUEEN; ++type)
+	{
+		Bitboard b = pos.pieces(Us, type);
+		while (b)
+			score += PIECE_TABLES[type][popLsb(b) ^ FLIP];
+	}
+	Bitboard king = pos.pieces(Us, W_KING);
+	if (king)
+		score += (endgame ? KING_ENDGAME_TABLE : KING_MIDDLEGAME_TABLE)[popLsb(king) ^ FLIP];
+	return score;
+}
+
+int evaluate(const Position &pos)
+{
+	int whitePieces = pos.getMaterial(true) - PIECE_VALUE[W_PAWN] * pos.getPieceCount(W_PAWN);
+	int blackPieces = pos.getMaterial(false) - PIECE_VALUE[W_PAWN] * pos.getPieceCount(B_PAWN);
+	bool endgame = whitePieces <= ENDGAME_MATERIAL && blackPieces <= ENDGAME_MATERIAL;
+
+	int score = evaluateSide<WHITE>(pos, endgame) - evaluateSide<BLACK>(pos, endgame);
+	return pos.isWhiteToMove() ? score : -score;
+}
@@ -0,0 +1,11 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "Position.h"
+
+// Static evaluation in centipawns from the side to move's point of view: material plus a
+// piece-square bonus for each piece, with the king table switching to the endgame one
+// once both sides are down to a rook and minor piece or so
+int evaluate(const Position &pos);
+
+#endif // EVALUATE_H
@@ -0,0 +1,1367 @@
+#include "Position.h"
+#include "Zobrist.h"
+#include "Stats.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cctype>
+
+// Set up the starting position
+Position::Position()
+{
+	m_whiteToMove = true; // White always makes the first move
+	m_enPassantSquare = -1;
+	m_castlingRights = ALL_CASTLING;
+	m_halfmoveClock = 0;
+
+	clearBoard();
+
+	// Set the starting board position
+	const int backRank[8] = {W_ROOK, W_KNIGHT, W_BISHOP, W_QUEEN, W_KING, W_BISHOP, W_KNIGHT, W_ROOK};
+	for (int col = 0; col < 8; col++)
+	{
+		putPiece(squareOf(0, col), -backRank[col]); // Black pieces
+		putPiece(squareOf(1, col), B_PAWN);			// Black Pawns
+		putPiece(squareOf(6, col), W_PAWN);			// White Pawns
+		putPiece(squareOf(7, col), backRank[col]);	// White pieces
+	}
+	m_key ^= stateKey();
+}
+
+bool Position::setFen(const std::string &fen)
+{
+	std::istringstream in(fen);
+	std::string placement, side, castling = "-", enPassant = "-";
+	int halfmoveClock = 0;
+	if (!(in >> placement >> side))
+		return false;
+	in >> castling >> enPassant >> halfmoveClock;
+
+	// Built on the side and only copied in once the whole string has parsed
+	Position pos;
+	pos.clearBoard();
+
+	// Ranks come from 8 down to 1, which is our square order (a8 = 0). Each must cover 8 squares
+	int row = 0, col = 0;
+	for (char c : placement)
+	{
+		if (c == '/')
+		{
+			if (col != 8 || ++row > 7)
+				return false;
+			col = 0;
+			continue;
+		}
+		if (c >= '1' && c <= '8')
+		{
+			col += c - '0';
+			if (col > 8)
+				return false;
+			continue;
+		}
+		const char *types = " pnbrqk";
+		const char *found = c == ' ' ? nullptr : std::strchr(types, std::tolower(c));
+		if (!found || col >= 8)
+			return false;
+		int type = int(found - types);
+		pos.putPiece(squareOf(row, col++), std::isupper(c) ? type : -type);
+	}
+	if (row != 7 || col != 8 || pos.m_pieceCount[W_KING + 6] != 1 || pos.m_pieceCount[B_KING + 6] != 1)
+		return false;
+
+	// A pawn can never stand on the first or last rank
+	if (pos.m_byType[W_PAWN] & (ROW_0 | ROW_7))
+		return false;
+
+	if (side != "w" && side != "b")
+		return false;
+	pos.m_whiteToMove = side == "w";
+
+	// The side that just moved cannot have left its king in check. Move generation would
+	// capture the king, which the rest of the engine assumes never happens
+	if (pos.isKingInCheck(!pos.m_whiteToMove))
+		return false;
+
+	pos.m_castlingRights = NO_CASTLING;
+	for (char c : castling)
+	{
+		switch (c)
+		{
+		case 'K':
+			pos.m_castlingRights |= WHITE_KING_SIDE;
+			break;
+		case 'Q':
+			pos.m_castlingRights |= WHITE_QUEEN_SIDE;
+			break;
+		case 'k':
+			pos.m_castlingRights |= BLACK_KING_SIDE;
+			break;
+		case 'q':
+			pos.m_castlingRights |= BLACK_QUEEN_SIDE;
+			break;
+		case '-':
+			break;
+		default:
+			return false;
+		}
+	}
+	// Rights whose king or rook is not on its home square could never be used
+	if (pos.m_board[60] != W_KING)
+		pos.m_castlingRights &= ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE);
+	if (pos.m_board[4] != B_KING)
+		pos.m_castlingRights &= ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE);
+	if (pos.m_board[63] != W_ROOK)
+		pos.m_castlingRights &= ~WHITE_KING_SIDE;
+	if (pos.m_board[56] != W_ROOK)
+		pos.m_castlingRights &= ~WHITE_QUEEN_SIDE;
+	if (pos.m_board[7] != B_ROOK)
+		pos.m_castlingRights &= ~BLACK_KING_SIDE;
+	if (pos.m_board[0] != B_ROOK)
+		pos.m_castlingRights &= ~BLACK_QUEEN_SIDE;
+
+	pos.m_enPassantSquare = -1;
+	if (enPassant != "-")
+	{
+		if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' ||
+			enPassant[1] != (pos.m_whiteToMove ? '6' : '3'))
+			return false;
+		pos.m_enPassantSquare = squareOf('8' - enPassant[1], enPassant[0] - 'a');
+
+		// The pawn that just moved two squares must be behind the square, with the square and
+		// the one it came from empty
+		int up = pos.m_whiteToMove ? -8 : 8; // Forward for the side to move
+		if (pos.m_board[pos.m_enPassantSquare - up] != (pos.m_whiteToMove ? B_PAWN : W_PAWN) ||
+			pos.m_board[pos.m_enPassantSquare] != EMPTY || pos.m_board[pos.m_enPassantSquare + up] != EMPTY)
+			return false;
+	}
+
+	pos.m_halfmoveClock = uint16_t(std::max(0, halfmoveClock));
+	pos.m_key ^= pos.stateKey();
+	*this = pos;
+	return true;
+}
+
+void Position::clearBoard()
+{
+	for (int i = 0; i < 7; ++i)
+		m_byType[i] = 0;
+	m_byColor[WHITE] = m_byColor[BLACK] = 0;
+	for (int sq = 0; sq < 64; ++sq)
+		m_board[sq] = EMPTY;
+	for (int i = 0; i < 13; ++i)
+		m_pieceCount[i] = 0;
+	m_material[WHITE] = m_material[BLACK] = 0;
+	m_kingSquare[WHITE] = m_kingSquare[BLACK] = -1;
+	m_key = 0;
+}
+
+void Position::putPiece(int sq, int piece)
+{
+	Bitboard b = squareBB(sq);
+	int type = std::abs(piece);
+	Color c = piece > 0 ? WHITE : BLACK;
+	m_board[sq] = piece;
+	m_byType[EMPTY] |= b;
+	m_byType[type] |= b;
+	m_byColor[c] |= b;
+	m_key ^= ZOBRIST.pieceSquare[piece + 6][sq];
+	m_pieceCount[piece + 6]++;
+	m_material[c] += PIECE_VALUE[type];
+	if (type == W_KING)
+		m_kingSquare[c] = sq;
+}
+
+void Position::removePiece(int sq)
+{
+	int piece = m_board[sq];
+	if (piece == EMPTY)
+		return;
+
+	Bitboard b = squareBB(sq);
+	int type = std::abs(piece);
+	Color c = piece > 0 ? WHITE : BLACK;
+	m_board[sq] = EMPTY;
+	m_byType[EMPTY] &= ~b;
+	m_byType[type] &= ~b;
+	m_byColor[c] &= ~b;
+	m_key ^= ZOBRIST.pieceSquare[piece + 6][sq];
+	m_pieceCount[piece + 6]--;
+	m_material[c] -= PIECE_VALUE[type];
+	if (type == W_KING)
+		m_kingSquare[c] = -1;
+}
+
+void Position::movePiece(int from, int to)
+{
+	int piece = m_board[from];
+	if (piece == EMPTY)
+		return;
+
+	removePiece(from);
+	putPiece(to, piece);
+}
+
+uint64_t Position::stateKey() const
+{
+	uint64_t key = ZOBRIST.castling[m_castlingRights];
+	if (!m_whiteToMove)
+		key ^= ZOBRIST.blackToMove;
+
+	// The en passant file only counts when a pawn of the side to move can capture there,
+	// so positions that play the same way share a key
+	if (m_enPassantSquare != -1)
+	{
+		Color us = m_whiteToMove ? WHITE : BLACK;
+		if (pawnAttacks(us == WHITE ? BLACK : WHITE, m_enPassantSquare) & pieces(us, W_PAWN))
+			key ^= ZOBRIST.enPassantFile[colOf(m_enPassantSquare)];
+	}
+	return key;
+}
+
+uint64_t Position::hash() const
+{
+	return m_key;
+}
+
+void Position::addMoves(MoveList &moves, int from, Bitboard targets)
+{
+	while (targets)
+	{
+		int to = popLsb(targets);
+		moves.push_back(Move(from, to));
+	}
+}
+
+// Is it white's turn
+bool Position::isWhiteToMove() const
+{
+	return m_whiteToMove;
+}
+
+// print function
+void Position::print()
+{
+	std::cout << "\n a b c d e f g h\n";
+	std::cout << "-------------------\n";
+
+	for (int row = 0; row < 8; ++row)
+	{
+		std::cout << 8 - row << "|"; // print row number
+		for (int col = 0; col < 8; ++col)
+		{
+			std::cout << getPieceChar(m_board[squareOf(row, col)]) << "|";
+		}
+		std::cout << " " << 8 - row << "\n"; // print row number again
+	}
+	std::cout << "-------------------\n";
+	std::cout << " a b c d e f g h\n\n";
+}
+
+// Helper function to map piece integers to display characters
+char Position::getPieceChar(int piece)
+{
+	switch (piece)
+	{
+	case EMPTY:
+		return ' ';
+	case W_PAWN:
+		return 'P';
+	case W_KNIGHT:
+		return 'N';
+	case W_BISHOP:
+		return 'B';
+	case W_ROOK:
+		return 'R';
+	case W_QUEEN:
+		return 'Q';
+	case W_KING:
+		return 'K';
+	case B_PAWN:
+		return 'p';
+	case B_KNIGHT:
+		return 'n';
+	case B_BISHOP:
+		return 'b';
+	case B_ROOK:
+		return 'r';
+	case B_QUEEN:
+		return 'q';
+	case B_KING:
+		return 'k';
+	default:
+		return '?'; // Should not happen
+	}
+}
+
+// Castling rights that survive a move touching each square. A move from or to
+// e1/a1/h1/e8/a8/h8 (king or rook moving, or a rook being captured) clears the matching rights
+static const uint8_t CASTLING_MASK[64] = {
+	15 & ~BLACK_QUEEN_SIDE, 15, 15, 15, 15 & ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE), 15, 15, 15 & ~BLACK_KING_SIDE,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15, 15, 15, 15, 15, 15, 15, 15,
+	15 & ~WHITE_QUEEN_SIDE, 15, 15, 15, 15 & ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE), 15, 15, 15 & ~WHITE_KING_SIDE};
+
+Move Position::withFlag(const Move &move) const
+{
+	if (move.flag() != NORMAL_MOVE)
+		return move;
+
+	int from = move.from();
+	int to = move.to();
+	switch (std::abs(m_board[from]))
+	{
+	case W_PAWN:
+		if (to == m_enPassantSquare)
+			return Move(from, to, EN_PASSANT);
+		if (std::abs(from - to) == 16)
+			return Move(from, to, DOUBLE_PAWN_PUSH);
+		break;
+	case W_KING:
+		if (std::abs(from - to) == 2)
+			return Move(from, to, CASTLING);
+		break;
+	}
+	return move;
+}
+
+void Position::makeMove(const Move &move, UndoInfo &undo)
+{
+	STAT_SCOPE(STAT_MAKE_MOVE);
+	if (m_whiteToMove)
+		makeMoveAs<WHITE>(move, undo);
+	else
+		makeMoveAs<BLACK>(move, undo);
+}
+
+void Position::unmakeMove(const Move &move, const UndoInfo &undo)
+{
+	// m_whiteToMove is still the opponent of the side that made the move
+	if (m_whiteToMove)
+		unmakeMoveAs<BLACK>(move, undo);
+	else
+		unmakeMoveAs<WHITE>(move, undo);
+}
+
+void Position::makeNullMove(UndoInfo &undo)
+{
+	undo.captured = EMPTY;
+	undo.castlingRights = m_castlingRights;
+	undo.enPassantSquare = m_enPassantSquare;
+	undo.halfmoveClock = m_halfmoveClock;
+	undo.key = m_key;
+
+	m_key ^= stateKey();
+	m_enPassantSquare = -1;
+	m_halfmoveClock = 0;
+	m_whiteToMove = !m_whiteToMove;
+	m_key ^= stateKey();
+}
+
+void Position::unmakeNullMove(const UndoInfo &undo)
+{
+	m_whiteToMove = !m_whiteToMove;
+	m_enPassantSquare = undo.enPassantSquare;
+	m_halfmoveClock = undo.halfmoveClock;
+	m_key = undo.key;
+}
+
+template <Color Us>
+void Position::makeMoveAs(const Move &move, UndoInfo &undo)
+{
+	constexpr int UP = Us == WHITE ? -8 : 8; // Square offset of one step forward
+	int from = move.from();
+	int to = move.to();
+
+	undo.captured = m_board[to]; // Piece on target square
+	undo.castlingRights = m_castlingRights;
+	undo.enPassantSquare = m_enPassantSquare;
+	undo.halfmoveClock = m_halfmoveClock;
+	undo.key = m_key;
+
+	// Captures and pawn moves can never be undone over the board, so they restart the clock
+	m_halfmoveClock = (undo.captured != EMPTY || (m_byType[W_PAWN] & squareBB(from))) ? 0 : m_halfmoveClock + 1;
+
+	// The pieces update the key as they move; take out the rest of the old state here
+	m_key ^= stateKey();
+
+	// Disable Castling Rights
+	m_castlingRights &= CASTLING_MASK[from] & CASTLING_MASK[to];
+	m_enPassantSquare = -1;
+
+	// Make the move
+	removePiece(to);
+	movePiece(from, to);
+
+	switch (move.flag())
+	{
+	case NORMAL_MOVE:
+		break;
+	case DOUBLE_PAWN_PUSH:
+		// New En Passant target: the square the pawn skipped over
+		m_enPassantSquare = to - UP;
+		break;
+	case CASTLING:
+		// Handle Rook's move: kingside goes h -> f, queenside a -> d
+		if (colOf(to) == 6)
+			movePiece(to + 1, to - 1);
+		else
+			movePiece(to - 2, to + 1);
+		break;
+	case EN_PASSANT:
+		// The captured pawn sits behind the target square
+		undo.captured = m_board[to - UP];
+		removePiece(to - UP);
+		break;
+	default:
+		// Handle promotion
+		removePiece(to);
+		putPiece(to, Us == WHITE ? move.promotionType() : -move.promotionType());
+		break;
+	}
+
+	// Flip the turn
+	m_whiteToMove = (Us != WHITE);
+	m_key ^= stateKey();
+}
+
+template <Color Us>
+void Position::unmakeMoveAs(const Move &move, const UndoInfo &undo)
+{
+	constexpr int UP = Us == WHITE ? -8 : 8;
+	m_whiteToMove = (Us == WHITE);
+
+	int from = move.from();
+	int to = move.to();
+
+	// Take the piece back, turning a promoted piece back into a pawn
+	if (move.isPromotion())
+	{
+		removePiece(to);
+		putPiece(from, Us == WHITE ? W_PAWN : B_PAWN);
+	}
+	else
+	{
+		movePiece(to, from);
+	}
+
+	if (move.flag() == CASTLING)
+	{
+		// Put the rook back
+		if (colOf(to) == 6)
+			movePiece(to - 1, to + 1);
+		else
+			movePiece(to + 1, to - 2);
+	}
+
+	// Restore the captured piece, behind the target square for en passant
+	if (undo.captured != EMPTY)
+	{
+		putPiece(move.flag() == EN_PASSANT ? to - UP : to, undo.captured);
+	}
+
+	m_castlingRights = undo.castlingRights;
+	m_enPassantSquare = undo.enPassantSquare;
+	m_halfmoveClock = undo.halfmoveClock;
+	m_key = undo.key;
+}
+
+template <int PieceType>
+static inline Bitboard attacksFrom(int sq, Bitboard occupied)
+{
+	switch (PieceType)
+	{
+	case W_KNIGHT:
+		return knightAttacks(sq);
+	case W_BISHOP:
+		return bishopAttacks(sq, occupied);
+	case W_ROOK:
+		return rookAttacks(sq, occupied);
+	case W_QUEEN:
+		return queenAttacks(sq, occupied);
+	default:
+		return kingAttacks(sq);
+	}
+}
+
+// One step towards the opponent's side of the board
+template <Color Us>
+static inline Bitboard pawnPush(Bitboard b)
+{
+	return Us == WHITE ? shiftNorth(b) : shiftSouth(b);
+}
+
+// Add a pawn move to every target square, coming from `offset` squares back
+static inline void addPawnMoves(MoveList &moves, Bitboard targets, int offset)
+{
+	while (targets)
+	{
+		int to = popLsb(targets);
+		moves.push_back(Move(to - offset, to));
+	}
+}
+
+// Same for targets on the last row: each one becomes the four promotions
+static inline void addPromotions(MoveList &moves, Bitboard targets, int offset)
+{
+	while (targets)
+	{
+		int to = popLsb(targets);
+		moves.push_back(Move(to - offset, to, MoveFlag(PROMOTION + W_QUEEN - W_KNIGHT)));
+		moves.push_back(Move(to - offset, to, MoveFlag(PROMOTION + W_ROOK - W_KNIGHT)));
+		moves.push_back(Move(to - offset, to, MoveFlag(PROMOTION + W_BISHOP - W_KNIGHT)));
+		moves.push_back(Move(to - offset, to, MoveFlag(PROMOTION + W_KNIGHT - W_KNIGHT)));
+	}
+}
+
+// The counter of a piece type's generator. StatId lists them in piece type order
+constexpr StatId generatorStat(int pieceType)
+{
+	return StatId(STAT_GET_PAWN_MOVES + pieceType - W_PAWN);
+}
+
+template <Color Us, MoveGenType Type>
+void Position::generatePawnMoves(MoveList &moves, Bitboard pawns) const
+{
+	STAT_MOVES_SCOPE(STAT_GET_PAWN_MOVES, moves);
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+	constexpr int UP = Us == WHITE ? -8 : 8; // Square offset of one step forward
+	constexpr Bitboard THIRD_ROW = Us == WHITE ? ROW_0 << 40 : ROW_0 << 16; // Reached by the first of two steps
+	constexpr Bitboard PROMOTION_ROW = Us == WHITE ? ROW_0 : ROW_7;
+
+	Bitboard empty = ~m_byType[EMPTY];
+	Bitboard enemies = m_byColor[Them];
+
+	// All pawns at once: one step forward, and captures towards col 0 and towards col 7
+	Bitboard one_step = pawnPush<Us>(pawns) & empty;
+	Bitboard west_captures = pawnPush<Us>(shiftWest(pawns)) & enemies;
+	Bitboard east_captures = pawnPush<Us>(shiftEast(pawns)) & enemies;
+
+	if (Type != QUIET_MOVES)
+	{
+		// Promotions count as captures whether or not they take something
+		addPromotions(moves, one_step & PROMOTION_ROW, UP);
+		addPromotions(moves, west_captures & PROMOTION_ROW, UP - 1);
+		addPromotions(moves, east_captures & PROMOTION_ROW, UP + 1);
+		addPawnMoves(moves, west_captures & ~PROMOTION_ROW, UP - 1);
+		addPawnMoves(moves, east_captures & ~PROMOTION_ROW, UP + 1);
+
+		// En passant: our pawns that attack the target square
+		if (m_enPassantSquare != -1)
+		{
+			Bitboard capturers = pawnAttacks(Them, m_enPassantSquare) & pawns;
+			while (capturers)
+			{
+				moves.push_back(Move(popLsb(capturers), m_enPassantSquare, EN_PASSANT));
+			}
+		}
+	}
+
+	if (Type != CAPTURES_AND_PROMOTIONS)
+	{
+		// A second step for the pawns that came from the start row
+		Bitboard two_steps = pawnPush<Us>(one_step & THIRD_ROW) & empty;
+		addPawnMoves(moves, one_step & ~PROMOTION_ROW, UP);
+		while (two_steps)
+		{
+			int to = popLsb(two_steps);
+			moves.push_back(Move(to - 2 * UP, to, DOUBLE_PAWN_PUSH));
+		}
+	}
+}
+
+template <Color Us, int PieceType>
+void Position::generatePieceMoves(MoveList &moves, Bitboard pieces, Bitboard targets) const
+{
+	STAT_MOVES_SCOPE(generatorStat(PieceType), moves);
+	while (pieces)
+	{
+		int from = popLsb(pieces);
+
+		// Slider attacks already stop at the first piece in each direction.
+		// `targets` drops the landing square if that piece is friendly
+		addMoves(moves, from, attacksFrom<PieceType>(from, m_byType[EMPTY]) & targets);
+	}
+}
+
+template <Color Us>
+void Position::generateCastling(MoveList &moves, Bitboard danger) const
+{
+	constexpr int KING_FROM = Us == WHITE ? squareOf(7, 4) : squareOf(0, 4); // e1 / e8
+	constexpr uint8_t KING_SIDE = Us == WHITE ? WHITE_KING_SIDE : BLACK_KING_SIDE;
+	constexpr uint8_t QUEEN_SIDE = Us == WHITE ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+
+	// Squares between king and rook that must be empty
+	constexpr Bitboard KING_SIDE_EMPTY = squareBB(KING_FROM + 1) | squareBB(KING_FROM + 2);
+	constexpr Bitboard QUEEN_SIDE_EMPTY = squareBB(KING_FROM - 1) | squareBB(KING_FROM - 2) | squareBB(KING_FROM - 3);
+
+	// Squares the king crosses and lands on, which must not be attacked
+	constexpr Bitboard KING_SIDE_SAFE = KING_SIDE_EMPTY;
+	constexpr Bitboard QUEEN_SIDE_SAFE = squareBB(KING_FROM - 1) | squareBB(KING_FROM - 2);
+
+	Bitboard occupied = m_byType[EMPTY];
+
+	// Kingside (0-0): the king crosses f and lands on g
+	if ((m_castlingRights & KING_SIDE) && !(occupied & KING_SIDE_EMPTY) && !(danger & KING_SIDE_SAFE))
+	{
+		moves.push_back(Move(KING_FROM, KING_FROM + 2, CASTLING));
+		STAT_MOVES(STAT_GET_KING_MOVES, 1);
+	}
+	// Queen side (0-0-0): the king crosses d and lands on c
+	if ((m_castlingRights & QUEEN_SIDE) && !(occupied & QUEEN_SIDE_EMPTY) && !(danger & QUEEN_SIDE_SAFE))
+	{
+		moves.push_back(Move(KING_FROM, KING_FROM - 2, CASTLING));
+		STAT_MOVES(STAT_GET_KING_MOVES, 1);
+	}
+}
+
+void Position::getPawnMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+	if (m_board[from] == W_PAWN)
+		generatePawnMoves<WHITE, ALL_MOVES>(moves, squareBB(from));
+	else if (m_board[from] == B_PAWN)
+		generatePawnMoves<BLACK, ALL_MOVES>(moves, squareBB(from));
+}
+
+void Position::getKnightMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+
+	// Get the color of the knight
+	// We can check if the piece > 0 (White) or < 0 (Black)
+	if (m_board[from] > 0)
+		generatePieceMoves<WHITE, W_KNIGHT>(moves, squareBB(from), ~m_byColor[WHITE]);
+	else
+		generatePieceMoves<BLACK, W_KNIGHT>(moves, squareBB(from), ~m_byColor[BLACK]);
+}
+
+void Position::getRookMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+	if (m_board[from] > 0)
+		generatePieceMoves<WHITE, W_ROOK>(moves, squareBB(from), ~m_byColor[WHITE]);
+	else
+		generatePieceMoves<BLACK, W_ROOK>(moves, squareBB(from), ~m_byColor[BLACK]);
+}
+
+void Position::getBishopMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+	if (m_board[from] > 0)
+		generatePieceMoves<WHITE, W_BISHOP>(moves, squareBB(from), ~m_byColor[WHITE]);
+	else
+		generatePieceMoves<BLACK, W_BISHOP>(moves, squareBB(from), ~m_byColor[BLACK]);
+}
+
+void Position::getQueenMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+	if (m_board[from] > 0)
+		generatePieceMoves<WHITE, W_QUEEN>(moves, squareBB(from), ~m_byColor[WHITE]);
+	else
+		generatePieceMoves<BLACK, W_QUEEN>(moves, squareBB(from), ~m_byColor[BLACK]);
+}
+
+void Position::getKingMoves(int row, int col, MoveList &moves)
+{
+	int from = squareOf(row, col);
+	bool isWhite = (m_board[from] > 0);
+
+	// Generate Castling Moves
+	// One attack map answers both "in check?" and "are the squares it crosses safe?"
+	Bitboard danger = isWhite ? attackedSquares<BLACK>(m_byType[EMPTY]) : attackedSquares<WHITE>(m_byType[EMPTY]);
+	if (!(danger & squareBB(from)))
+	{ // Not in check
+		if (isWhite)
+			generateCastling<WHITE>(moves, danger);
+		else
+			generateCastling<BLACK>(moves, danger);
+	}
+
+	if (isWhite)
+		generatePieceMoves<WHITE, W_KING>(moves, squareBB(from), ~m_byColor[WHITE]);
+	else
+		generatePieceMoves<BLACK, W_KING>(moves, squareBB(from), ~m_byColor[BLACK]);
+}
+
+void Position::getLegalMoves(MoveList &moves)
+{
+	getLegalMoves(moves, ALL_MOVES);
+}
+
+void Position::getLegalMoves(MoveList &moves, MoveGenType type)
+{
+	STAT_SCOPE(STAT_GET_LEGAL_MOVES);
+
+	// Pick the color once; everything below is compiled separately for each side
+	if (m_whiteToMove)
+		generateLegalMoves<WHITE>(moves, type);
+	else
+		generateLegalMoves<BLACK>(moves, type);
+	STAT_MOVES(STAT_GET_LEGAL_MOVES, moves.size());
+}
+
+template <Color Us, MoveGenType Type>
+void Position::generatePseudoLegalMoves(MoveList &moves, Bitboard danger, Bitboard checkers) const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+
+	// Pieces other than pawns capture onto enemy pieces and move quietly onto empty squares
+	Bitboard targets = Type == CAPTURES_AND_PROMOTIONS ? m_byColor[Them]
+					   : Type == QUIET_MOVES		   ? ~m_byType[EMPTY]
+													   : ~m_byColor[Us];
+
+	// In double check only the king can move
+	if (!(checkers & (checkers - 1)))
+	{
+		generatePawnMoves<Us, Type>(moves, pieces(Us, W_PAWN));
+		generatePieceMoves<Us, W_KNIGHT>(moves, pieces(Us, W_KNIGHT), targets);
+		generatePieceMoves<Us, W_BISHOP>(moves, pieces(Us, W_BISHOP), targets);
+		generatePieceMoves<Us, W_ROOK>(moves, pieces(Us, W_ROOK), targets);
+		generatePieceMoves<Us, W_QUEEN>(moves, pieces(Us, W_QUEEN), targets);
+	}
+	generatePieceMoves<Us, W_KING>(moves, pieces(Us, W_KING), targets & ~danger);
+	if (Type != CAPTURES_AND_PROMOTIONS && !checkers)
+	{
+		generateCastling<Us>(moves, danger);
+	}
+}
+
+template <Color Us>
+void Position::generateLegalMoves(MoveList &moves, MoveGenType type) const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+
+	// Checks and pins are worked out once here, so each candidate is
+	// accepted or rejected with a few mask tests instead of being played.
+	// The attack map is taken with our king off the board, so a square further along a
+	// checking slider's line does not look safe to step back to
+	int kingSquare = m_kingSquare[Us];
+	Bitboard occupied = m_byType[EMPTY];
+	Bitboard danger = attackedSquares<Them>(occupied ^ squareBB(kingSquare));
+	Bitboard checkers = (danger & squareBB(kingSquare)) ? attackersTo(kingSquare, occupied) & m_byColor[Them] : 0;
+	Bitboard pinned = pinnedPieces<Us>(kingSquare);
+
+	// All moves of the requested kind before check-testing.
+	// Checking moves can be of any kind, so they start from the full list
+	moves.clear();
+	switch (type)
+	{
+	case CAPTURES_AND_PROMOTIONS:
+		generatePseudoLegalMoves<Us, CAPTURES_AND_PROMOTIONS>(moves, danger, checkers);
+		break;
+	case QUIET_MOVES:
+		generatePseudoLegalMoves<Us, QUIET_MOVES>(moves, danger, checkers);
+		break;
+	default:
+		generatePseudoLegalMoves<Us, ALL_MOVES>(moves, danger, checkers);
+		break;
+	}
+
+	// Only needed to pick out the checking moves
+	int theirKing = 0;
+	Bitboard discoverers = 0;
+	if (type == CHECKING_MOVES)
+	{
+		theirKing = m_kingSquare[Them];
+		discoverers = discoveredCheckers<Us>(theirKing);
+	}
+
+	// Keep the legal moves, compacting them to the front of the list.
+	// King moves already avoided the attack map
+	int legalCount = 0;
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		if (moves[i].from() != kingSquare && !leavesKingSafe<Us>(moves[i], kingSquare, pinned, checkers))
+		{
+			STAT_REJECTED(STAT_GET_LEGAL_MOVES, 1);
+			continue;
+		}
+		if (type != CHECKING_MOVES || givesCheckAs<Us>(moves[i], theirKing, discoverers))
+			moves[legalCount++] = moves[i];
+	}
+	moves.resize(legalCount); // Fully filtered
+}
+
+std::vector<Move> Position::getLegalMoves()
+{
+	return getLegalMoves(ALL_MOVES);
+}
+
+std::vector<Move> Position::getLegalMoves(MoveGenType type)
+{
+	MoveList moves;
+	getLegalMoves(moves, type);
+	return std::vector<Move>(moves.begin(), moves.end());
+}
+
+bool Position::hasLegalMove()
+{
+	if (m_whiteToMove)
+		return hasLegalMoveAs<WHITE>();
+	return hasLegalMoveAs<BLACK>();
+}
+
+template <Color Us>
+bool Position::hasLegalMoveAs() const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+
+	int kingSquare = m_kingSquare[Us];
+	Bitboard occupied = m_byType[EMPTY];
+	Bitboard targets = ~m_byColor[Us];
+
+	// The king first: it usually has a move, and it is the only piece that can move in double check.
+	// A safe square is any target outside the attack map (taken without our king, see generateLegalMoves).
+	// Castling is never needed, since it is only legal when the king's first step is too
+	Bitboard danger = attackedSquares<Them>(occupied ^ squareBB(kingSquare));
+	if (kingAttacks(kingSquare) & targets & ~danger)
+		return true;
+
+	Bitboard checkers = (danger & squareBB(kingSquare)) ? attackersTo(kingSquare, occupied) & m_byColor[Them] : 0;
+	if (checkers & (checkers - 1))
+		return false;
+	Bitboard pinned = pinnedPieces<Us>(kingSquare);
+
+	// Then one piece type at a time, so the search stops as soon as one move is found
+	MoveList moves;
+	auto anyLegal = [&]()
+	{
+		for (const Move &move : moves)
+		{
+			if (leavesKingSafe<Us>(move, kingSquare, pinned, checkers))
+				return true;
+		}
+		moves.clear();
+		return false;
+	};
+
+	generatePieceMoves<Us, W_KNIGHT>(moves, pieces(Us, W_KNIGHT), targets);
+	if (anyLegal())
+		return true;
+	generatePawnMoves<Us, ALL_MOVES>(moves, pieces(Us, W_PAWN));
+	if (anyLegal())
+		return true;
+	generatePieceMoves<Us, W_BISHOP>(moves, pieces(Us, W_BISHOP), targets);
+	if (anyLegal())
+		return true;
+	generatePieceMoves<Us, W_ROOK>(moves, pieces(Us, W_ROOK), targets);
+	if (anyLegal())
+		return true;
+	generatePieceMoves<Us, W_QUEEN>(moves, pieces(Us, W_QUEEN), targets);
+	return anyLegal();
+}
+
+bool Position::isLegal(const Move &move)
+{
+	Move full = withFlag(move);
+	Color us = m_whiteToMove ? WHITE : BLACK;
+	int kingSquare = m_kingSquare[us];
+	Bitboard checkers = attackersTo(kingSquare, m_byType[EMPTY]) & m_byColor[us == WHITE ? BLACK : WHITE];
+
+	if (us == WHITE)
+		return isPseudoLegal<WHITE>(full, checkers != 0) &&
+			   leavesKingSafe<WHITE>(full, kingSquare, pinnedPieces<WHITE>(kingSquare), checkers);
+	return isPseudoLegal<BLACK>(full, checkers != 0) &&
+		   leavesKingSafe<BLACK>(full, kingSquare, pinnedPieces<BLACK>(kingSquare), checkers);
+}
+
+template <Color Us>
+bool Position::isPseudoLegal(const Move &move, bool inCheck) const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+	constexpr int UP = Us == WHITE ? -8 : 8;
+	constexpr Bitboard START_ROW = Us == WHITE ? ROW_0 << 48 : ROW_0 << 8;
+	constexpr Bitboard PROMOTION_ROW = Us == WHITE ? ROW_0 : ROW_7;
+
+	int from = move.from();
+	int to = move.to();
+	Bitboard occupied = m_byType[EMPTY];
+	Bitboard target = squareBB(to);
+
+	// One of our pieces, moving to a square that does not hold another.
+	// Flags past the queen promotion are not used by any move
+	if (!(m_byColor[Us] & squareBB(from)) || (m_byColor[Us] & target) ||
+		move.flag() > PROMOTION + W_QUEEN - W_KNIGHT)
+		return false;
+
+	int pieceType = m_board[from] < 0 ? -m_board[from] : m_board[from];
+	if (pieceType != W_PAWN)
+	{
+		if (move.flag() == CASTLING)
+		{
+			// Few enough to just generate them and look
+			MoveList castles;
+			if (pieceType != W_KING || inCheck)
+				return false;
+			generateCastling<Us>(castles, attackedSquares<Them>(occupied));
+			return (castles.size() > 0 && castles[0] == move) || (castles.size() > 1 && castles[1] == move);
+		}
+		if (move.flag() != NORMAL_MOVE)
+			return false;
+
+		switch (pieceType)
+		{
+		case W_KNIGHT:
+			return knightAttacks(from) & target;
+		case W_BISHOP:
+			return bishopAttacks(from, occupied) & target;
+		case W_ROOK:
+			return rookAttacks(from, occupied) & target;
+		case W_QUEEN:
+			return queenAttacks(from, occupied) & target;
+		default:
+			return kingAttacks(from) & target;
+		}
+	}
+
+	// Pawns promote exactly when they reach the last row
+	if (bool(target & PROMOTION_ROW) != move.isPromotion())
+		return false;
+
+	switch (move.flag())
+	{
+	case DOUBLE_PAWN_PUSH:
+		return (squareBB(from) & START_ROW) && to == from + 2 * UP &&
+			   !(occupied & (squareBB(from + UP) | target));
+	case EN_PASSANT:
+		return to == m_enPassantSquare && (pawnAttacks(Us, from) & target);
+	case CASTLING:
+		return false;
+	default:
+		// A single step onto an empty square, or a diagonal capture
+		return (to == from + UP && !(occupied & target)) ||
+			   (pawnAttacks(Us, from) & target & m_byColor[Them]);
+	}
+}
+
+bool Position::givesCheck(const Move &move)
+{
+	if (m_whiteToMove)
+	{
+		int theirKing = m_kingSquare[BLACK];
+		return givesCheckAs<WHITE>(move, theirKing, discoveredCheckers<WHITE>(theirKing));
+	}
+	int theirKing = m_kingSquare[WHITE];
+	return givesCheckAs<BLACK>(move, theirKing, discoveredCheckers<BLACK>(theirKing));
+}
+
+template <Color Us>
+Bitboard Position::discoveredCheckers(int theirKing) const
+{
+	Bitboard discoverers = 0;
+
+	// Our sliders that would attack their king on an empty board
+	Bitboard snipers = ((rookAttacks(theirKing, 0) & (m_byType[W_ROOK] | m_byType[W_QUEEN])) |
+						(bishopAttacks(theirKing, 0) & (m_byType[W_BISHOP] | m_byType[W_QUEEN]))) &
+					   m_byColor[Us];
+	while (snipers)
+	{
+		int sniper = popLsb(snipers);
+		Bitboard blockers = BETWEEN[theirKing][sniper] & m_byType[EMPTY];
+
+		// Exactly one piece in the way, and it is ours
+		if (blockers && !(blockers & (blockers - 1)))
+		{
+			discoverers |= blockers & m_byColor[Us];
+		}
+	}
+	return discoverers;
+}
+
+template <Color Us>
+bool Position::givesCheckAs(const Move &move, int theirKing, Bitboard discoverers) const
+{
+	int from = move.from();
+	int to = move.to();
+	Bitboard king = squareBB(theirKing);
+	Bitboard occupied = m_byType[EMPTY] ^ squareBB(from); // The moving piece has left
+
+	if (move.flag() == CASTLING || move.flag() == EN_PASSANT)
+	{
+		// Both move or remove a second piece, which the discovered check test does not cover.
+		// Rare enough to simply look at our sliders in the position after the move
+		Bitboard rooks = pieces(Us, W_ROOK) | pieces(Us, W_QUEEN);
+		Bitboard bishops = pieces(Us, W_BISHOP) | pieces(Us, W_QUEEN);
+		occupied |= squareBB(to);
+		if (move.flag() == CASTLING)
+		{
+			int rookFrom = colOf(to) == 6 ? to + 1 : to - 2;
+			int rookTo = colOf(to) == 6 ? to - 1 : to + 1;
+			occupied ^= squareBB(rookFrom) ^ squareBB(rookTo);
+			rooks ^= squareBB(rookFrom) ^ squareBB(rookTo);
+		}
+		else
+		{
+			occupied ^= squareBB(Us == WHITE ? to + 8 : to - 8);
+			if (pawnAttacks(Us, to) & king)
+				return true;
+		}
+		return (rookAttacks(theirKing, occupied) & rooks) || (bishopAttacks(theirKing, occupied) & bishops);
+	}
+
+	// Moving a blocker off the line between one of our sliders and their king
+	if ((discoverers & squareBB(from)) && !(LINE[from][theirKing] & squareBB(to)))
+		return true;
+
+	// The moved (or promoted) piece attacking the king from its new square.
+	// Leaving `from` can open a line for the piece itself (a promotion along the last row)
+	int pieceType = move.isPromotion() ? move.promotionType() : (m_board[from] < 0 ? -m_board[from] : m_board[from]);
+	switch (pieceType)
+	{
+	case W_PAWN:
+		return pawnAttacks(Us, to) & king;
+	case W_KNIGHT:
+		return knightAttacks(to) & king;
+	case W_BISHOP:
+		return bishopAttacks(to, occupied) & king;
+	case W_ROOK:
+		return rookAttacks(to, occupied) & king;
+	case W_QUEEN:
+		return queenAttacks(to, occupied) & king;
+	default:
+		return false; // A king never gives check itself
+	}
+}
+
+int Position::see(const Move &move) const
+{
+	Move full = withFlag(move);
+	if (full.flag() == CASTLING)
+		return 0;
+
+	int from = full.from();
+	int to = full.to();
+	Color side = m_board[from] > 0 ? WHITE : BLACK;
+	Bitboard occupied = m_byType[EMPTY] ^ squareBB(from);
+
+	// gain[d] is what the side making capture d wins if the sequence stopped right after it.
+	// Each capture removes a piece, so there are never more than 32
+	int gain[32];
+	int depth = 0;
+	int onSquare = std::abs(m_board[from]); // Type of the piece that would be taken next
+
+	gain[0] = PIECE_VALUE[std::abs(m_board[to])];
+	if (full.flag() == EN_PASSANT)
+	{
+		gain[0] = PIECE_VALUE[W_PAWN];
+		occupied ^= squareBB(side == WHITE ? to + 8 : to - 8);
+	}
+	if (full.isPromotion())
+	{
+		gain[0] += PIECE_VALUE[full.promotionType()] - PIECE_VALUE[W_PAWN];
+		onSquare = full.promotionType();
+	}
+
+	Bitboard rooks = m_byType[W_ROOK] | m_byType[W_QUEEN];
+	Bitboard bishops = m_byType[W_BISHOP] | m_byType[W_QUEEN];
+	Bitboard attackers = attackersTo(to, occupied) & occupied;
+
+	while (true)
+	{
+		side = side == WHITE ? BLACK : WHITE;
+		Bitboard ours = attackers & m_byColor[side];
+		if (!ours)
+			break;
+
+		// Least valuable attacker
+		int type = W_PAWN;
+		while (!(ours & m_byType[type]))
+			++type;
+
+		// The king may only take when nothing can take it back
+		if (type == W_KING && (attackers & m_byColor[side == WHITE ? BLACK : WHITE]))
+			break;
+
+		++depth;
+		gain[depth] = PIECE_VALUE[onSquare] - gain[depth - 1];
+		onSquare = type;
+
+		// Take the attacker off and add any slider it was hiding (x-ray)
+		Bitboard attacker = ours & m_byType[type];
+		occupied ^= attacker & (0 - attacker);
+		if (type == W_PAWN || type == W_BISHOP || type == W_QUEEN)
+			attackers |= bishopAttacks(to, occupied) & bishops;
+		if (type == W_ROOK || type == W_QUEEN)
+			attackers |= rookAttacks(to, occupied) & rooks;
+		attackers &= occupied;
+	}
+
+	// Walk back: each side either makes its capture or stops before it, whichever is better for it
+	while (depth > 0)
+	{
+		gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+		--depth;
+	}
+	return gain[0];
+}
+
+Bitboard Position::attackersTo(int sq, Bitboard occupied) const
+{
+	return (pawnAttacks(BLACK, sq) & pieces(WHITE, W_PAWN)) |
+		   (pawnAttacks(WHITE, sq) & pieces(BLACK, W_PAWN)) |
+		   (knightAttacks(sq) & m_byType[W_KNIGHT]) |
+		   (kingAttacks(sq) & m_byType[W_KING]) |
+		   (rookAttacks(sq, occupied) & (m_byType[W_ROOK] | m_byType[W_QUEEN])) |
+		   (bishopAttacks(sq, occupied) & (m_byType[W_BISHOP] | m_byType[W_QUEEN]));
+}
+
+template <Color Us>
+Bitboard Position::pinnedPieces(int kingSquare) const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+	Bitboard pinned = 0;
+
+	// Enemy sliders that would attack the king on an empty board
+	Bitboard snipers = ((rookAttacks(kingSquare, 0) & (m_byType[W_ROOK] | m_byType[W_QUEEN])) |
+						(bishopAttacks(kingSquare, 0) & (m_byType[W_BISHOP] | m_byType[W_QUEEN]))) &
+					   m_byColor[Them];
+	while (snipers)
+	{
+		int sniper = popLsb(snipers);
+		Bitboard blockers = BETWEEN[kingSquare][sniper] & m_byType[EMPTY];
+
+		// Exactly one piece in the way, and it is ours
+		if (blockers && !(blockers & (blockers - 1)))
+		{
+			pinned |= blockers & m_byColor[Us];
+		}
+	}
+	return pinned;
+}
+
+template <Color Us>
+bool Position::leavesKingSafe(const Move &move, int kingSquare, Bitboard pinned, Bitboard checkers) const
+{
+	constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+	int from = move.from();
+	int to = move.to();
+	Bitboard occupied = m_byType[EMPTY];
+
+	if (from == kingSquare)
+	{
+		// Castling squares were already checked in generateCastling
+		if (move.flag() == CASTLING)
+			return true;
+
+		// The target square must not be attacked. Take the king off the board first,
+		// otherwise it would shield the square behind it from a slider it moves away from
+		return !isAttackedBy<Them>(to, occupied ^ squareBB(from));
+	}
+
+	// In double check only the king can move
+	if (checkers & (checkers - 1))
+		return false;
+
+	// En passant removes two pieces from the capturing row, which can uncover a slider
+	// in a way the pin mask does not see. Just look at the position after the capture
+	if (move.flag() == EN_PASSANT)
+	{
+		int captureSquare = Us == WHITE ? to + 8 : to - 8;
+		Bitboard after = (occupied ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(to);
+		return !(attackersTo(kingSquare, after) & m_byColor[Them] & ~squareBB(captureSquare));
+	}
+
+	// In single check the move has to capture the checker or step in between
+	if (checkers && !((BETWEEN[kingSquare][lsb(checkers)] | checkers) & squareBB(to)))
+		return false;
+
+	// A pinned piece can only move along the line through its king
+	return !(pinned & squareBB(from)) || (LINE[from][kingSquare] & squareBB(to));
+}
+
+template <Color By>
+Bitboard Position::attackedSquares(Bitboard occupied) const
+{
+	Bitboard queens = pieces(By, W_QUEEN);
+	return pawnAttacksBB(By, pieces(By, W_PAWN)) |
+		   knightAttacksBB(pieces(By, W_KNIGHT)) |
+		   kingAttacksBB(pieces(By, W_KING)) |
+		   slidingAttacksBB(pieces(By, W_ROOK) | queens, pieces(By, W_BISHOP) | queens, occupied);
+}
+
+template <Color By>
+bool Position::isAttackedBy(int sq, Bitboard occupied) const
+{
+	constexpr Color Defender = By == WHITE ? BLACK : WHITE;
+
+	// Pawns: look from the target square with the defender's pawn pattern.
+	// Any attacking pawn must sit on one of those squares
+	if (pawnAttacks(Defender, sq) & pieces(By, W_PAWN))
+		return true;
+
+	if (knightAttacks(sq) & pieces(By, W_KNIGHT))
+		return true;
+
+	if (kingAttacks(sq) & pieces(By, W_KING))
+		return true;
+
+	// Sliding attacks: a rook/queen on a straight ray, a bishop/queen on a diagonal
+	Bitboard queens = pieces(By, W_QUEEN);
+	if (rookAttacks(sq, occupied) & (pieces(By, W_ROOK) | queens))
+		return true;
+	if (bishopAttacks(sq, occupied) & (pieces(By, W_BISHOP) | queens))
+		return true;
+
+	// If we've checked everything and found nothing
+	return false;
+}
+
+bool Position::isSquareAttacked(int row, int col, bool byWhite)
+{
+	STAT_SCOPE(STAT_IS_SQUARE_ATTACKED);
+	int sq = squareOf(row, col);
+	if (byWhite)
+		return isAttackedBy<WHITE>(sq, m_byType[EMPTY]);
+	return isAttackedBy<BLACK>(sq, m_byType[EMPTY]);
+}
+
+std::pair<int, int> Position::findKing(bool whiteKing)
+{
+	int sq = m_kingSquare[whiteKing ? WHITE : BLACK];
+	if (sq != -1)
+	{
+		return {rowOf(sq), colOf(sq)};
+	}
+	// This should never happen in a real game, but it's good to have
+	return {-1, -1};
+}
+
+bool Position::isKingInCheck(bool whiteKing)
+{
+	// Find the king
+	std::pair<int, int> king_pos = findKing(whiteKing);
+
+	// Check if that square is attacked by the OPPONENT
+	// if we're checking the white King, we check for attacks by Black (!whiteKing)
+	return isSquareAttacked(king_pos.first, king_pos.second, !whiteKing);
+}
+
+std::vector<std::vector<int>> Position::getBoardState()
+{
+	// Create an 8x8 vector
+	std::vector<std::vector<int>> board_state(8, std::vector<int>(8));
+
+	for (int row = 0; row < 8; ++row)
+	{
+		for (int col = 0; col < 8; ++col)
+		{
+			board_state[row][col] = m_board[squareOf(row, col)];
+		}
+	}
+	return board_state;
+}
+
+bool Position::checkInsufficientMaterial()
+{
+	// This is a helper to check for draws like K vs K, K+N vs K, etc
+
+	// If there are any pawns, rooks, or queens, it's not a draw
+	if (getPieceCount(W_PAWN) + getPieceCount(B_PAWN) + getPieceCount(W_ROOK) + getPieceCount(B_ROOK) +
+		getPieceCount(W_QUEEN) + getPieceCount(B_QUEEN))
+	{
+		return false;
+	}
+
+	int white_knights = getPieceCount(W_KNIGHT);
+	int black_knights = getPieceCount(B_KNIGHT);
+	int white_bishops = getPieceCount(W_BISHOP);
+	int black_bishops = getPieceCount(B_BISHOP);
+
+	// K vs K
+	if (white_knights + white_bishops + black_knights + black_bishops == 0)
+	{
+		return true;
+	}
+
+	// K+N vs K
+	if (white_knights == 1 && (black_knights + black_bishops == 0))
+	{
+		return true;
+	}
+	if (black_knights == 1 && (white_knights + white_bishops == 0))
+	{
+		return true;
+	}
+
+	// K+B vs K
+	if (white_bishops == 1 && (black_knights + black_bishops == 0))
+	{
+		return true;
+	}
+	if (black_bishops == 1 && (white_knights + white_bishops == 0))
+	{
+		return true;
+	}
+
+	// K+B vs K+B (both bishops on same color)
+	if (white_bishops == 1 && black_bishops == 1 && white_knights == 0 && black_knights == 0)
+	{
+		bool white_bishop_color = (pieces(WHITE, W_BISHOP) & LIGHT_SQUARES) != 0;
+		bool black_bishop_color = (pieces(BLACK, W_BISHOP) & LIGHT_SQUARES) != 0;
+		if (white_bishop_color == black_bishop_color)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<std::vector<std::vector<int>>> Position::getFeaturePlanes() {
+	// Initialize our 18x8x8 tensor, with all values set to 0
+	std::vector<std::vector<std::vector<int>>> planes(18, std::vector<std::vector<int>>(8, std::vector<int>(8, 0)));
+
+	// Planes 0-11: Piece Positions
+	for (int r = 0; r < 8; ++r) {
+		for (int c = 0; c < 8; ++c) {
+			int piece = m_board[squareOf(r, c)];
+			int plane_idx = -1;
+
+			switch (piece) {
+				case W_PAWN:   plane_idx = 0; break;
+				case W_KNIGHT: plane_idx = 1; break;
+                case W_BISHOP: plane_idx = 2; break;
+                case W_ROOK:   plane_idx = 3; break;
+                case W_QUEEN:  plane_idx = 4; break;
+                case W_KING:   plane_idx = 5; break;
+                case B_PAWN:   plane_idx = 6; break;
+                case B_KNIGHT: plane_idx = 7; break;
+                case B_BISHOP: plane_idx = 8; break;
+                case B_ROOK:   plane_idx = 9; break;
+                case B_QUEEN:  plane_idx = 10; break;
+                case B_KING:   plane_idx = 11; break;
+
+				}
+
+			if (plane_idx != -1) {
+				planes[plane_idx][r][c] = 1;
+			}
+		}
+	}
+
+	// Planes 12 - 15: Castling Rights
+	if (m_castlingRights & WHITE_KING_SIDE) std::fill(planes[12].begin(), planes[12].end(), std::vector<int>(8, 1));
+	if (m_castlingRights & WHITE_QUEEN_SIDE) std::fill(planes[13].begin(), planes[13].end(), std::vector<int>(8, 1));
+	if (m_castlingRights & BLACK_KING_SIDE) std::fill(planes[14].begin(), planes[14].end(), std::vector<int>(8, 1));
+	if (m_castlingRights & BLACK_QUEEN_SIDE) std::fill(planes[15].begin(), planes[15].end(), std::vector<int>(8, 1));
+
+	// Plane 16: En passant target (single capture)
+	if (m_enPassantSquare != -1) {
+		planes[16][rowOf(m_enPassantSquare)][colOf(m_enPassantSquare)] = 1;
+	}
+
+	// Plane 17: Player's Turn (full plane). Zeros for Black
+	if (m_whiteToMove) {
+		std::fill(planes[17].begin(), planes[17].end(), std::vector<int>(8, 1));
+	}
+
+	return planes;
+}
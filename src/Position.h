@@ -0,0 +1,418 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include "Bitboard.h"
+
+// Use simple integer to represent pieces (for now)
+// Positive = White, Negative = Black
+// 0 = Empty, 1 = Pawn, 2 = Knight, 3 = Bishop, 4 = Rook, 5 = Queen, 6 = King
+
+enum Piece
+{
+	EMPTY = 0,
+	W_PAWN = 1,
+	W_KNIGHT = 2,
+	W_BISHOP = 3,
+	W_ROOK = 4,
+	W_QUEEN = 5,
+	W_KING = 6,
+	B_PAWN = -1,
+	B_KNIGHT = -2,
+	B_BISHOP = -3,
+	B_ROOK = -4,
+	B_QUEEN = -5,
+	B_KING = -6
+};
+
+// Material value of each piece type in centipawns, indexed by unsigned piece type.
+// The king is never traded, so it counts for nothing
+constexpr int PIECE_VALUE[7] = {0, 100, 320, 330, 500, 900, 0};
+
+// Castling rights, stored together as one bit mask
+enum CastlingRight
+{
+	NO_CASTLING = 0,
+	WHITE_KING_SIDE = 1,
+	WHITE_QUEEN_SIDE = 2,
+	BLACK_KING_SIDE = 4,
+	BLACK_QUEEN_SIDE = 8,
+	ALL_CASTLING = 15
+};
+
+// What kind of move a Move is. Stored in the top 4 bits of the move
+enum MoveFlag
+{
+	NORMAL_MOVE = 0,
+	DOUBLE_PAWN_PUSH = 1,
+	CASTLING = 2,
+	EN_PASSANT = 3,
+	PROMOTION = 4 // 4..7: promotion to knight, bishop, rook, queen (PROMOTION + type - W_KNIGHT)
+};
+
+// Which legal moves to generate. Captures and quiet moves split the full list between them:
+// every promotion (capturing or not) and en passant count as captures, castling as a quiet move
+enum MoveGenType
+{
+	CAPTURES_AND_PROMOTIONS = 0,
+	QUIET_MOVES = 1,
+	CHECKING_MOVES = 2, // Any move that gives check, of either kind
+	ALL_MOVES = 3
+};
+
+// A move packed into 16 bits: from square (bits 0-5), to square (bits 6-11), MoveFlag (bits 12-15).
+// Squares are row * 8 + col. The (row, col) constructors build the same thing for callers
+// that think in rows and columns
+struct Move
+{
+	// Left uninitialised so a MoveList can be declared without touching its 256 slots
+	Move() = default;
+
+	// Constructor for Normal moves
+	// Castling, en passant and double pushes built this way have no flag yet; makeMove(move)
+	// and isLegal fill it in from the position
+	Move(int fr, int fc, int tr, int tc) : Move(squareOf(fr, fc), squareOf(tr, tc)) {}
+
+	// Constructor for promotions. pp is the piece to promote to (either color), or EMPTY
+	Move(int fr, int fc, int tr, int tc, int pp)
+		: Move(squareOf(fr, fc), squareOf(tr, tc),
+			   pp == EMPTY ? NORMAL_MOVE : MoveFlag(PROMOTION + (pp < 0 ? -pp : pp) - W_KNIGHT)) {}
+
+	// Used by the move generators
+	Move(int from, int to, MoveFlag flag = NORMAL_MOVE) : m_data(uint16_t(from | to << 6 | flag << 12)) {}
+
+	// Does not check `data`: moves from outside the engine must pass isValidEncoding first
+	static Move fromEncoded(uint16_t data)
+	{
+		Move move;
+		move.m_data = data;
+		return move;
+	}
+
+	uint16_t encoded() const { return m_data; }
+
+	// Flags above the queen promotion are unused, and would index past the piece tables
+	static bool isValidEncoding(uint16_t data) { return (data >> 12) <= PROMOTION + W_QUEEN - W_KNIGHT; }
+
+	int from() const { return m_data & 63; }
+	int to() const { return (m_data >> 6) & 63; }
+	MoveFlag flag() const { return MoveFlag(m_data >> 12); }
+
+	int fromRow() const { return rowOf(from()); }
+	int fromCol() const { return colOf(from()); }
+	int toRow() const { return rowOf(to()); }
+	int toCol() const { return colOf(to()); }
+
+	bool isPromotion() const { return flag() >= PROMOTION; }
+
+	// Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q"
+	std::string uci() const
+	{
+		std::string s = {char('a' + fromCol()), char('8' - fromRow()), char('a' + toCol()), char('8' - toRow())};
+		if (isPromotion())
+			s += " nbrq"[promotionType() - W_PAWN];
+		return s;
+	}
+
+	// Unsigned piece type promoted to (W_KNIGHT .. W_QUEEN). Only valid for promotions
+	int promotionType() const { return flag() - PROMOTION + W_KNIGHT; }
+
+	// Signed piece promoted to, or EMPTY. White promotes on row 0, Black on row 7
+	int promotionPiece() const
+	{
+		if (!isPromotion())
+			return EMPTY;
+		return toRow() == 0 ? promotionType() : -promotionType();
+	}
+
+	bool operator==(const Move &other) const { return m_data == other.m_data; }
+	bool operator!=(const Move &other) const { return m_data != other.m_data; }
+
+private:
+	uint16_t m_data;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay packed in 16 bits");
+
+// A fixed-capacity list of moves, meant to live on the stack so that generating moves
+// never allocates. 256 is above the largest number of moves possible in a chess position (218)
+class MoveList
+{
+public:
+	static const int MAX_MOVES = 256;
+
+	MoveList() : m_size(0) {}
+
+	void push_back(const Move &move) { m_moves[m_size++] = move; }
+	void clear() { m_size = 0; }
+	void resize(int size) { m_size = size; }
+
+	int size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	Move &operator[](int i) { return m_moves[i]; }
+	const Move &operator[](int i) const { return m_moves[i]; }
+
+	Move *begin() { return m_moves; }
+	Move *end() { return m_moves + m_size; }
+	const Move *begin() const { return m_moves; }
+	const Move *end() const { return m_moves + m_size; }
+
+private:
+	Move m_moves[MAX_MOVES];
+	int m_size;
+};
+
+// Everything makeMove destroys that unmakeMove cannot work out from the move itself.
+// Small enough to live on the stack of a search or perft
+struct UndoInfo
+{
+	int8_t captured;		// Piece taken by the move (EMPTY if none)
+	uint8_t castlingRights; // Castling rights before the move
+	int8_t enPassantSquare; // En passant square before the move (-1 if none)
+	uint16_t halfmoveClock; // Halfmove clock before the move
+	uint64_t key;			// Zobrist key before the move
+};
+
+// Everything about where the game stands right now: the pieces, side to move, castling
+// rights and en passant square, plus what is derived from them (Zobrist key, counts).
+// There is no history in here and nothing on the heap, so a Position is a plain value that
+// can be copied with memcpy. Search and self-play can copy it freely (copy-make) instead of
+// unmaking moves. Board adds the game history on top
+class Position
+{
+public:
+	// The starting position
+	Position();
+
+	// Set up the position described by a FEN string. The move counters may be left off.
+	// Returns false (leaving the position as it was) if the string cannot be parsed or the
+	// position could not arise: ranks not 8 squares long, pawns on the first or last rank, the
+	// side not to move in check, or an en passant square with no pawn that just moved past it
+	bool setFen(const std::string &fen);
+
+	// Print the board to the console
+	void print();
+
+	// Plays the move in place and fills `undo` with what unmakeMove needs to take it back.
+	// The move must carry its flag, as generated moves do
+	void makeMove(const Move &move, UndoInfo &undo);
+	void unmakeMove(const Move &move, const UndoInfo &undo);
+
+	// Passes the turn without moving a piece, for null-move pruning in the search. Not a legal
+	// chess move: the side to move must not be in check. The en passant square goes, and the
+	// halfmove clock restarts so that no repetition is found across the null move
+	void makeNullMove(UndoInfo &undo);
+	void unmakeNullMove(const UndoInfo &undo);
+
+	// A function to get all legal moves for a pawn at a specific square
+	// The piece generators append to `moves` and do not check whether the move leaves the king in check
+	void getPawnMoves(int row, int col, MoveList &moves);
+
+	// Knight's move generator
+	void getKnightMoves(int row, int col, MoveList &moves);
+
+	// Rook's move generator
+	void getRookMoves(int row, int col, MoveList &moves);
+
+	// Bishop's move generator
+	void getBishopMoves(int row, int col, MoveList &moves);
+
+	// Queen's move generator
+	void getQueenMoves(int row, int col, MoveList &moves);
+
+	// King's move generator
+	void getKingMoves(int row, int col, MoveList &moves);
+
+	// Master function to get all moves for the current player.
+	// Fills `moves` (which is cleared first) without any heap allocation
+	void getLegalMoves(MoveList &moves);
+
+	// Same, returned as a vector for callers that want to keep the list (Python, the GUI)
+	std::vector<Move> getLegalMoves();
+
+	// Only the legal moves of one kind (see MoveGenType). Cheaper than generating
+	// everything and filtering, since the other kinds are never produced
+	void getLegalMoves(MoveList &moves, MoveGenType type);
+	std::vector<Move> getLegalMoves(MoveGenType type);
+
+	// Whether the side to move has any legal move at all. Stops at the first one found,
+	// so it is much cheaper than generating the list when the answer is yes
+	bool hasLegalMove();
+
+	// Whether a move is legal for the side to move, answered from the attack and pin masks
+	// without generating the move list. Moves built from rows and columns may leave out
+	// their flag, as with Board::makeMove
+	bool isLegal(const Move &move);
+
+	// Whether a legal move for the side to move gives check
+	bool givesCheck(const Move &move);
+
+	// Static exchange evaluation: the material the side to move wins (in centipawns, negative
+	// if it loses) when it plays `move` and both sides then keep recapturing on the target square
+	// with their least valuable piece, each stopping when that no longer pays. Works on the
+	// attack sets only, revealing sliders behind pieces as they leave; pins are not considered
+	int see(const Move &move) const;
+
+	// Checks if a square is attacked by a given side
+	bool isSquareAttacked(int row, int col, bool byWhite);
+
+	// Check the current king's status
+	// We pass 'true' to check the white king, 'false' for black
+	bool isKingInCheck(bool whiteKing);
+
+	// A function to get the board state as a 2D vector
+	std::vector<std::vector<int>> getBoardState();
+
+	// Function to say whose turn it is
+	bool isWhiteToMove() const;
+
+	// 64-bit Zobrist key of the position (pieces, side to move, castling rights, en passant file).
+	// Kept up to date by every move, so it costs nothing to read
+	uint64_t hash() const;
+
+	// Number of pieces of one kind on the board (piece is signed, e.g. B_KNIGHT)
+	int getPieceCount(int piece) const { return m_pieceCount[piece + 6]; }
+
+	// Piece on a square (row * 8 + col), EMPTY if none
+	int pieceOn(int sq) const { return m_board[sq]; }
+
+	// Pieces of one type (unsigned, e.g. W_KNIGHT) and color
+	Bitboard pieces(Color c, int pieceType) const { return m_byType[pieceType] & m_byColor[c]; }
+
+	// Total PIECE_VALUE of one side's pieces
+	int getMaterial(bool white) const { return m_material[white ? WHITE : BLACK]; }
+
+	// Plies since the last capture or pawn move (the fifty-move rule counts to 100).
+	// Only those plies can lead back to an earlier position
+	int getHalfmoveClock() const { return m_halfmoveClock; }
+
+    // Return the board state as feature planes for RL
+    std::vector<std::vector<std::vector<int>>> getFeaturePlanes();
+
+protected:
+	// Set the flag of a move built from squares only (castling, en passant, double push)
+	Move withFlag(const Move &move) const;
+
+	// Helper for draw detection
+	bool checkInsufficientMaterial();
+
+private:
+	// Helper function to get the character for a piece
+	char getPieceChar(int piece);
+
+	// Bitboards: one set per piece type, indexed like Piece (W_PAWN .. W_KING).
+	// Index 0 (EMPTY) holds every occupied square
+	Bitboard m_byType[7];
+
+	// One set per side, indexed by Color
+	Bitboard m_byColor[2];
+
+	// Zobrist key of the position. The piece part is kept by putPiece/removePiece
+	uint64_t m_key;
+
+	// Piece on each square (row * 8 + col). Kept in sync with the bitboards
+	// so that "what is on this square" stays a single lookup
+	int8_t m_board[64];
+
+	// Counts kept alongside the bitboards by putPiece/removePiece, so the game status
+	// and material queries never have to look at the board.
+	// m_pieceCount is indexed by piece + 6, like the Zobrist keys
+	int m_material[2];
+	uint8_t m_pieceCount[13];
+	int8_t m_kingSquare[2]; // -1 while a side has no king (only while setting up a position)
+
+	// A variable to track whose turn it is
+	bool m_whiteToMove;
+
+	// The square (row * 8 + col) that is vulerable to en passant. -1 if none.
+	int8_t m_enPassantSquare;
+
+	// Castling rights (CastlingRight bits)
+	uint8_t m_castlingRights;
+
+	uint16_t m_halfmoveClock;
+
+	// The part of the key that is not pieces: castling rights, en passant file, side to move
+	uint64_t stateKey() const;
+
+	// Bitboard maintenance. Every change to the position goes through these
+	void putPiece(int sq, int piece);
+	void removePiece(int sq);
+	void movePiece(int from, int to);
+	void clearBoard();
+
+	// Append a move from `from` to every square in `targets`
+	static void addMoves(MoveList &moves, int from, Bitboard targets);
+
+	// Pieces of both colors that attack sq, for the given occupancy
+	Bitboard attackersTo(int sq, Bitboard occupied) const;
+
+	// The rest is specialised on the side it works for (template parameter Us / By), so that
+	// directions, rows and piece codes are compile-time constants in the inner loops.
+	// The public functions pick the color once and call into these
+
+	// Pseudo-legal moves: pawns (all the pawns in the set at once), one piece type onto
+	// `targets`, castling, and all of them for one MoveGenType.
+	// `danger` is the enemy attack map: the king and castling avoid it, so those moves come out legal
+	template <Color Us, MoveGenType Type>
+	void generatePawnMoves(MoveList &moves, Bitboard pawns) const;
+	template <Color Us, int PieceType>
+	void generatePieceMoves(MoveList &moves, Bitboard pieces, Bitboard targets) const;
+	template <Color Us>
+	void generateCastling(MoveList &moves, Bitboard danger) const;
+	template <Color Us, MoveGenType Type>
+	void generatePseudoLegalMoves(MoveList &moves, Bitboard danger, Bitboard checkers) const;
+
+	template <Color Us>
+	void generateLegalMoves(MoveList &moves, MoveGenType type) const;
+	template <Color Us>
+	bool hasLegalMoveAs() const;
+
+	// Whether a move (with its flag) is one the move generators could have produced
+	template <Color Us>
+	bool isPseudoLegal(const Move &move, bool inCheck) const;
+
+	// Our pieces that are the only thing between one of our sliders and the enemy king.
+	// Moving one of them off that line gives a discovered check
+	template <Color Us>
+	Bitboard discoveredCheckers(int theirKing) const;
+
+	template <Color Us>
+	bool givesCheckAs(const Move &move, int theirKing, Bitboard discoverers) const;
+
+	// Whether any piece of color By attacks sq, for the given occupancy
+	template <Color By>
+	bool isAttackedBy(int sq, Bitboard occupied) const;
+
+	// Every square attacked by color By, for the given occupancy. One call answers
+	// all the king-safety questions about a position at once
+	template <Color By>
+	Bitboard attackedSquares(Bitboard occupied) const;
+
+	// Our pieces that are the only thing between our king and an enemy slider
+	template <Color Us>
+	Bitboard pinnedPieces(int kingSquare) const;
+
+	// Whether a pseudo-legal move leaves our own king safe.
+	// Uses the pins and checkers worked out once per position instead of playing the move
+	template <Color Us>
+	bool leavesKingSafe(const Move &move, int kingSquare, Bitboard pinned, Bitboard checkers) const;
+
+	template <Color Us>
+	void makeMoveAs(const Move &move, UndoInfo &undo);
+	template <Color Us>
+	void unmakeMoveAs(const Move &move, const UndoInfo &undo);
+
+	// Helper to find the specified king (specified by `bool whiteKing`)
+	std::pair<int, int> findKing(bool whiteKing);
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must stay a plain value (no heap, no history)");
+static_assert(sizeof(Position) <= 192, "Position is copied on every node of a copy-make search; keep it small");
+
+#endif // POSITION_H
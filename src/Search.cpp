@@ -0,0 +1,543 @@
+#include "Search.h"
+#include "Evaluate.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static const Move NO_MOVE = Move::fromEncoded(0);
+
+// Selective search settings (see SearchOptions), margins in centipawns
+static const int ASPIRATION_WINDOW = 25;	   // Half width of the first window
+static const int ASPIRATION_DEPTH = 5;		   // From this depth on; shallower scores swing too much
+static const int NULL_MOVE_DEPTH = 3;		   // Least depth to try a null move at
+static const int REVERSE_FUTILITY_DEPTH = 6;   // Most depth left to cut a node at
+static const int REVERSE_FUTILITY_MARGIN = 120; // Per ply left
+static const int FUTILITY_MARGIN[4] = {0, 100, 200, 320}; // By depth left, up to 3
+
+static int64_t nowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+// Mate scores are stored relative to the node rather than the root, so that an entry
+// found at another ply still gives the right distance to mate
+static int scoreToTT(int score, int ply)
+{
+	if (score >= VALUE_MATE_IN_MAX_PLY)
+		return score + ply;
+	if (score <= -VALUE_MATE_IN_MAX_PLY)
+		return score - ply;
+	return score;
+}
+
+static int scoreFromTT(int score, int ply)
+{
+	if (score >= VALUE_MATE_IN_MAX_PLY)
+		return score - ply;
+	if (score <= -VALUE_MATE_IN_MAX_PLY)
+		return score + ply;
+	return score;
+}
+
+// An entry's fields packed into one word: move (bits 0-15), score (16-31), depth (32-39), bound (40-47)
+static uint64_t packEntry(Move move, int score, int depth, Bound bound)
+{
+	return uint64_t(move.encoded()) | uint64_t(uint16_t(score)) << 16 |
+		   uint64_t(uint8_t(depth)) << 32 | uint64_t(bound) << 40;
+}
+
+static TTEntry unpackEntry(uint64_t data)
+{
+	return {Move::fromEncoded(uint16_t(data)), int16_t(data >> 16), int8_t(data >> 32), uint8_t(data >> 40)};
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+	resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+	size_t count = 1;
+	while (count * 2 * sizeof(Slot) <= megabytes << 20)
+		count *= 2;
+	m_slots.reset(new Slot[count]);
+	m_mask = count - 1;
+}
+
+void TranspositionTable::clear()
+{
+	for (size_t i = 0; i <= m_mask; ++i)
+	{
+		m_slots[i].check.store(0, std::memory_order_relaxed);
+		m_slots[i].data.store(0, std::memory_order_relaxed);
+	}
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) const
+{
+	const Slot &slot = m_slots[key & m_mask];
+	uint64_t data = slot.data.load(std::memory_order_relaxed);
+	if ((slot.check.load(std::memory_order_relaxed) ^ data) != key)
+		return false;
+	entry = unpackEntry(data);
+	return entry.bound != BOUND_NONE;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound)
+{
+	Slot &slot = m_slots[key & m_mask];
+
+	// Keep a deeper result for the same position, but never lose its move to an entry without one
+	TTEntry old;
+	if (probe(key, old))
+	{
+		if (depth < old.depth - 2 && bound != BOUND_EXACT)
+			return;
+		if (move == NO_MOVE)
+			move = old.move;
+	}
+
+	uint64_t data = packEntry(move, score, depth, bound);
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+	slot.data.store(data, std::memory_order_relaxed);
+}
+
+Search::Search(TranspositionTable &table, const std::vector<uint64_t> &gameKeys)
+	: m_table(table), m_gameKeys(gameKeys), m_startMs(0), m_stop(false)
+{
+}
+
+int Search::maxThreads()
+{
+	return 4 * static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+SearchResult Search::run(const Position &root, const SearchLimits &limits)
+{
+	m_limits = limits;
+	m_limits.depth = std::max(0, limits.depth);
+	m_limits.movetimeMs = std::max(0, limits.movetimeMs);
+	m_limits.threads = std::clamp(limits.threads, 1, maxThreads());
+	if (!m_limits.depth && !m_limits.nodes && !m_limits.movetimeMs)
+		m_limits.depth = DEFAULT_DEPTH;
+	int maxDepth = m_limits.depth ? std::min(m_limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+
+	SearchResult result;
+	Position pos = root;
+	MoveList rootMoves;
+	pos.getLegalMoves(rootMoves);
+	if (rootMoves.empty())
+	{
+		result.score = pos.isKingInCheck(pos.isWhiteToMove()) ? -VALUE_MATE : 0;
+		return result;
+	}
+
+	m_threads.clear();
+	for (int i = 0; i < m_limits.threads; ++i)
+		m_threads.emplace_back(new SearchThread(*this, i));
+	m_startMs = nowMs();
+	m_stop = false;
+
+	// Helpers search until the main thread is done. Odd ones start a depth ahead
+	std::vector<std::thread> helpers;
+	for (size_t i = 1; i < m_threads.size(); ++i)
+	{
+		SearchThread *thread = m_threads[i].get();
+		helpers.emplace_back([thread, &root, i, maxDepth]()
+							 { thread->iterate(root, 1 + int(i & 1), maxDepth); });
+	}
+	m_threads[0]->iterate(root, 1, maxDepth);
+	m_stop = true;
+	for (std::thread &helper : helpers)
+		helper.join();
+
+	result = m_threads[0]->result();
+	result.nodes = totalNodes();
+	return result;
+}
+
+uint64_t Search::totalNodes() const
+{
+	uint64_t nodes = 0;
+	for (const std::unique_ptr<SearchThread> &thread : m_threads)
+		nodes += thread->nodes();
+	return nodes;
+}
+
+SearchThread::SearchThread(Search &owner, int id)
+	: m_owner(owner), m_id(id), m_keys(owner.m_gameKeys), m_nodes(0), m_rootDepth(0)
+{
+	std::fill(&m_killers[0][0], &m_killers[0][0] + MAX_PLY * 2, NO_MOVE);
+	std::memset(m_history, 0, sizeof(m_history));
+}
+
+void SearchThread::iterate(const Position &root, int firstDepth, int maxDepth)
+{
+	m_pos = root;
+	int score = 0;
+	for (m_rootDepth = firstDepth; m_rootDepth <= maxDepth; ++m_rootDepth)
+	{
+		score = searchRoot(score);
+
+		// An unfinished iteration is thrown away: its moves were not all compared
+		if (stopped())
+			break;
+
+		if (m_id == 0)
+		{
+			m_result.score = score;
+			m_result.depth = m_rootDepth;
+			m_result.pv.assign(m_pv[0], m_pv[0] + m_pvLength[0]);
+			m_result.bestMove = m_result.pv[0];
+			m_result.nodes = m_owner.totalNodes();
+			if (m_owner.m_onIteration)
+				m_owner.m_onIteration(m_result);
+		}
+
+		// No point looking deeper once a forced mate is found
+		if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY)
+			break;
+	}
+}
+
+int SearchThread::searchRoot(int previous)
+{
+	if (!m_owner.m_limits.options.aspiration || m_rootDepth < ASPIRATION_DEPTH || std::abs(previous) >= VALUE_MATE_IN_MAX_PLY)
+		return search(-VALUE_INFINITE, VALUE_INFINITE, m_rootDepth, 0, true);
+
+	// A score outside the window is only a bound, so that side of the window is opened
+	// further each time, until the score is exact
+	int delta = ASPIRATION_WINDOW;
+	int alpha = previous - delta;
+	int beta = previous + delta;
+	while (true)
+	{
+		int score = search(alpha, beta, m_rootDepth, 0, true);
+		if (stopped())
+			return score;
+		delta *= 2;
+		if (score <= alpha)
+			alpha = std::max(score - delta, -VALUE_INFINITE);
+		else if (score >= beta)
+			beta = std::min(score + delta, VALUE_INFINITE);
+		else
+			return score;
+	}
+}
+
+bool SearchThread::visitNode()
+{
+	uint64_t nodes = m_nodes.load(std::memory_order_relaxed) + 1;
+	m_nodes.store(nodes, std::memory_order_relaxed);
+
+	// Limits are read by the main thread only, every 1024 of its nodes, from depth 2 on
+	if (m_id == 0 && m_rootDepth > 1 && (nodes & 1023) == 0)
+	{
+		const SearchLimits &limits = m_owner.m_limits;
+		if ((limits.nodes && m_owner.totalNodes() >= limits.nodes) ||
+			(limits.movetimeMs && nowMs() - m_owner.m_startMs >= limits.movetimeMs))
+			m_owner.m_stop = true;
+	}
+	return stopped();
+}
+
+bool SearchThread::stopped() const
+{
+	return m_owner.m_stop.load(std::memory_order_relaxed);
+}
+
+bool SearchThread::isCapture(const Move &move) const
+{
+	return m_pos.pieceOn(move.to()) != EMPTY || move.flag() == EN_PASSANT || move.isPromotion();
+}
+
+bool SearchThread::isRepetitionOrFifty() const
+{
+	int clock = m_pos.getHalfmoveClock();
+	if (clock >= 100)
+		return true;
+
+	// Only positions since the last capture or pawn move can repeat, and only with the same side
+	// to move. m_keys.back() is the parent, so the grandparent is two back.
+	// Inside the search a single repetition already counts as a draw
+	uint64_t key = m_pos.hash();
+	int count = int(m_keys.size());
+	for (int back = 2; back <= clock && back <= count; back += 2)
+	{
+		if (m_keys[count - back] == key)
+			return true;
+	}
+	return false;
+}
+
+void SearchThread::scoreMoves(const MoveList &moves, int *scores, Move ttMove, int ply)
+{
+	int side = m_pos.isWhiteToMove() ? WHITE : BLACK;
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		const Move &move = moves[i];
+		if (move == ttMove)
+			scores[i] = 1 << 30;
+		else if (isCapture(move))
+		{
+			// Most valuable victim first, then least valuable attacker. Losing captures go last
+			int victim = move.flag() == EN_PASSANT ? W_PAWN : std::abs(m_pos.pieceOn(move.to()));
+			int attacker = std::abs(m_pos.pieceOn(move.from()));
+			int order = PIECE_VALUE[victim] * 8 - attacker + (move.isPromotion() ? PIECE_VALUE[move.promotionType()] : 0);
+			scores[i] = m_pos.see(move) >= 0 ? (1 << 24) + order : -(1 << 24) + order;
+		}
+		else if (move == m_killers[ply][0])
+			scores[i] = (1 << 22) + 1;
+		else if (move == m_killers[ply][1])
+			scores[i] = 1 << 22;
+		else
+			scores[i] = m_history[side][move.from()][move.to()];
+	}
+}
+
+// Moves the best-scored move from index i on to index i (one step of a selection sort),
+// so a node that cuts off early never sorts the rest
+static void pickMove(MoveList &moves, int *scores, int i)
+{
+	int best = i;
+	for (int j = i + 1; j < moves.size(); ++j)
+	{
+		if (scores[j] > scores[best])
+			best = j;
+	}
+	std::swap(moves[i], moves[best]);
+	std::swap(scores[i], scores[best]);
+}
+
+int SearchThread::search(int alpha, int beta, int depth, int ply, bool pvNode, bool nullAllowed)
+{
+	m_pvLength[ply] = ply;
+	if (depth <= 0 || ply >= MAX_PLY - 1)
+		return quiescence(alpha, beta, ply);
+
+	if (visitNode())
+		return 0;
+
+	if (ply > 0)
+	{
+		if (isRepetitionOrFifty())
+			return 0;
+
+		// Even a mate right here cannot beat a shorter mate already found
+		alpha = std::max(alpha, -VALUE_MATE + ply);
+		beta = std::min(beta, VALUE_MATE - ply - 1);
+		if (alpha >= beta)
+			return alpha;
+	}
+
+	uint64_t key = m_pos.hash();
+	TTEntry entry;
+	bool ttHit = m_owner.m_table.probe(key, entry);
+	Move ttMove = ttHit ? entry.move : NO_MOVE;
+	if (ttHit && !pvNode && entry.depth >= depth)
+	{
+		int ttScore = scoreFromTT(entry.score, ply);
+		if (entry.bound == BOUND_EXACT ||
+			(entry.bound == BOUND_LOWER && ttScore >= beta) ||
+			(entry.bound == BOUND_UPPER && ttScore <= alpha))
+			return ttScore;
+	}
+
+	bool inCheck = m_pos.isKingInCheck(m_pos.isWhiteToMove());
+	if (inCheck)
+		++depth; // Look one ply further at checks, so they are not cut short at the horizon
+
+	// Nothing is pruned or reduced in check or on the principal variation
+	const SearchOptions &options = m_owner.m_limits.options;
+	bool prune = !pvNode && !inCheck;
+	int staticEval = prune ? evaluate(m_pos) : -VALUE_INFINITE;
+
+	// Reverse futility: this far above beta so close to the leaves, the opponent is not
+	// expected to win enough back
+	if (prune && options.reverseFutility && depth <= REVERSE_FUTILITY_DEPTH &&
+		std::abs(beta) < VALUE_MATE_IN_MAX_PLY && staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta)
+		return staticEval;
+
+	// Null move: if passing the turn still fails high at a reduced depth, a real move would too.
+	// Not with only pawns left, where having to move can be what loses (zugzwang)
+	Color us = m_pos.isWhiteToMove() ? WHITE : BLACK;
+	if (prune && options.nullMove && nullAllowed && depth >= NULL_MOVE_DEPTH && staticEval >= beta &&
+		(m_pos.pieces(us, W_KNIGHT) | m_pos.pieces(us, W_BISHOP) | m_pos.pieces(us, W_ROOK) | m_pos.pieces(us, W_QUEEN)))
+	{
+		int reduction = 3 + depth / 6;
+		UndoInfo undo;
+		m_keys.push_back(key);
+		m_pos.makeNullMove(undo);
+		int score = -search(-beta, -beta + 1, depth - 1 - reduction, ply + 1, false, false);
+		m_pos.unmakeNullMove(undo);
+		m_keys.pop_back();
+		if (stopped())
+			return 0;
+
+		// A mate found after passing the turn is no proof of a real one
+		if (score >= beta)
+			return score >= VALUE_MATE_IN_MAX_PLY ? beta : score;
+	}
+
+	// Futility: so close to the leaves and this far below alpha, a quiet move will not get there
+	bool futile = prune && options.futility && depth < 4 && std::abs(alpha) < VALUE_MATE_IN_MAX_PLY &&
+				  staticEval + FUTILITY_MARGIN[depth] <= alpha;
+
+	MoveList moves;
+	m_pos.getLegalMoves(moves);
+	if (moves.empty())
+		return inCheck ? -VALUE_MATE + ply : 0;
+
+	int scores[MoveList::MAX_MOVES];
+	scoreMoves(moves, scores, ttMove, ply);
+
+	int bestScore = -VALUE_INFINITE;
+	Move bestMove = NO_MOVE;
+	int originalAlpha = alpha;
+
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		pickMove(moves, scores, i);
+		const Move move = moves[i];
+		bool capture = isCapture(move);
+
+		UndoInfo undo;
+		m_keys.push_back(key);
+		m_pos.makeMove(move, undo);
+
+		// Quiet moves after the first that do not give check are the ones pruned and reduced
+		bool lateQuiet = i > 0 && !capture && !m_pos.isKingInCheck(m_pos.isWhiteToMove());
+		if (futile && lateQuiet)
+		{
+			m_pos.unmakeMove(move, undo);
+			m_keys.pop_back();
+			bestScore = std::max(bestScore, staticEval + FUTILITY_MARGIN[depth]);
+			continue;
+		}
+
+		// The first move gets the full window; the others only have to prove they are no
+		// better, and are searched again with the full window if they turn out to be.
+		// Late quiet moves (not killers) first try to prove it at a reduced depth
+		int score;
+		int newDepth = depth - 1;
+		if (i == 0)
+			score = -search(-beta, -alpha, newDepth, ply + 1, pvNode);
+		else
+		{
+			int reduction = 0;
+			if (prune && options.lmr && lateQuiet && i >= 3 && depth >= 3 &&
+				move != m_killers[ply][0] && move != m_killers[ply][1])
+				reduction = std::min(1 + (i >= 6) + (depth >= 6), newDepth - 1);
+
+			score = -search(-alpha - 1, -alpha, newDepth - reduction, ply + 1, false);
+			if (reduction > 0 && score > alpha)
+				score = -search(-alpha - 1, -alpha, newDepth, ply + 1, false);
+			if (score > alpha && score < beta)
+				score = -search(-beta, -alpha, newDepth, ply + 1, true);
+		}
+
+		m_pos.unmakeMove(move, undo);
+		m_keys.pop_back();
+		if (stopped())
+			return 0;
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestMove = move;
+			if (score > alpha)
+			{
+				alpha = score;
+				m_pv[ply][ply] = move;
+				std::copy(m_pv[ply + 1] + ply + 1, m_pv[ply + 1] + m_pvLength[ply + 1], m_pv[ply] + ply + 1);
+				m_pvLength[ply] = m_pvLength[ply + 1];
+
+				if (score >= beta)
+				{
+					if (!capture)
+					{
+						if (m_killers[ply][0] != move)
+						{
+							m_killers[ply][1] = m_killers[ply][0];
+							m_killers[ply][0] = move;
+						}
+						// Kept below the killer scores, however many cutoffs pile up
+						int &history = m_history[us][move.from()][move.to()];
+						history = std::min(history + depth * depth, (1 << 22) - 1);
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+	m_owner.m_table.store(key, bestMove, scoreToTT(bestScore, ply), depth, bound);
+	return bestScore;
+}
+
+int SearchThread::quiescence(int alpha, int beta, int ply)
+{
+	if (visitNode())
+		return 0;
+
+	if (ply >= MAX_PLY - 1)
+		return evaluate(m_pos);
+
+	// In check every evasion is searched, since standing pat is not an option.
+	// Otherwise the side to move may stop capturing whenever it likes (stand pat)
+	bool inCheck = m_pos.isKingInCheck(m_pos.isWhiteToMove());
+	int bestScore = -VALUE_INFINITE;
+	MoveList moves;
+	if (inCheck)
+	{
+		m_pos.getLegalMoves(moves);
+		if (moves.empty())
+			return -VALUE_MATE + ply;
+	}
+	else
+	{
+		bestScore = evaluate(m_pos);
+		if (bestScore >= beta)
+			return bestScore;
+		alpha = std::max(alpha, bestScore);
+		m_pos.getLegalMoves(moves, CAPTURES_AND_PROMOTIONS);
+	}
+
+	int scores[MoveList::MAX_MOVES];
+	scoreMoves(moves, scores, NO_MOVE, ply);
+
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		pickMove(moves, scores, i);
+		const Move move = moves[i];
+
+		// Captures that lose material (by SEE) cannot raise a stand-pat score
+		if (!inCheck && scores[i] < 0)
+			break;
+
+		UndoInfo undo;
+		m_pos.makeMove(move, undo);
+		int score = -quiescence(-beta, -alpha, ply + 1);
+		m_pos.unmakeMove(move, undo);
+		if (stopped())
+			return 0;
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			if (score > alpha)
+			{
+				alpha = score;
+				if (score >= beta)
+					break;
+			}
+		}
+	}
+	return bestScore;
+}
@@ -0,0 +1,197 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Position.h"
+
+constexpr int MAX_PLY = 128;
+
+// Scores are centipawns from the side to move's point of view. A mate in n plies scores
+// VALUE_MATE - n (or -(VALUE_MATE - n) when being mated), so anything beyond
+// VALUE_MATE_IN_MAX_PLY is a forced mate
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// The selective parts of the search, each on by default. Turning one off searches more of the
+// tree to the same depth, which is how to measure what each is worth
+struct SearchOptions
+{
+	bool nullMove = true;		 // Pass the turn; if the reduced search still fails high, so would a move
+	bool lmr = true;			 // Late move reductions: search late quiet moves shallower first
+	bool futility = true;		 // Skip quiet moves near the leaves that cannot raise the score to alpha
+	bool reverseFutility = true; // Cut nodes near the leaves whose static score is far above beta
+	bool aspiration = true;		 // Search each depth in a narrow window around the last score
+};
+
+// When to stop. Zero (or less) means no limit; with no limit at all the search goes to
+// DEFAULT_DEPTH. Depth 1 is always completed, so there is always a move to play
+struct SearchLimits
+{
+	int depth = 0;
+	uint64_t nodes = 0; // Counted over all threads
+	int movetimeMs = 0;
+
+	// Not a limit, but chosen per search like them: how many threads search together (Lazy SMP),
+	// clamped to 1..Search::maxThreads()
+	int threads = 1;
+	SearchOptions options;
+};
+
+constexpr int DEFAULT_DEPTH = 6;
+
+struct SearchResult
+{
+	Move bestMove = Move::fromEncoded(0); // a8a8 (encoded 0) if there is no legal move
+	int score = 0;
+	int depth = 0;		 // Last depth completed
+	uint64_t nodes = 0;	 // Nodes visited, quiescence included
+	std::vector<Move> pv; // Principal variation, starting with bestMove
+};
+
+// What a transposition table score says about the true score
+enum Bound : uint8_t
+{
+	BOUND_NONE,
+	BOUND_UPPER, // Failed low: the true score is at most this
+	BOUND_LOWER, // Failed high: the true score is at least this
+	BOUND_EXACT
+};
+
+struct TTEntry
+{
+	Move move;
+	int16_t score;
+	int8_t depth;
+	uint8_t bound;
+};
+
+// Search results keyed by Zobrist key, so a position reached again by another move order
+// (or in the next iteration, or by another thread) is not searched twice and its best move
+// is tried first.
+// All search threads share one table without locks. An entry is packed into one 64-bit word
+// stored next to key ^ word, so an entry torn by two threads writing at once no longer
+// matches its key and reads as a miss
+class TranspositionTable
+{
+public:
+	explicit TranspositionTable(size_t megabytes = 16);
+
+	// Drop every entry and make the table about `megabytes` large (rounded down to a power of two entries)
+	void resize(size_t megabytes);
+	void clear();
+
+	// Copies the entry for `key` into `entry` if there is one
+	bool probe(uint64_t key, TTEntry &entry) const;
+	void store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> check{0}; // key ^ data
+		std::atomic<uint64_t> data{0};
+	};
+
+	std::unique_ptr<Slot[]> m_slots;
+	size_t m_mask;
+};
+
+class Search;
+
+// One thread's share of a search: its own copy of the position and its own move ordering
+// tables, with the transposition table and the stop flag shared through the Search.
+// Does iterative-deepening principal variation search (alpha-beta with null windows for every
+// move after the first) with quiescence search on captures at the leaves, pruned and reduced
+// as SearchOptions allow.
+// Moves are tried transposition table move first, then winning captures, killers, quiet moves
+// by history, losing captures
+class SearchThread
+{
+public:
+	SearchThread(Search &owner, int id);
+
+	// Searches the root one depth deeper at a time, from `firstDepth` up to `maxDepth`, until
+	// the search is stopped. Only the main thread (id 0) checks the limits and reports results
+	void iterate(const Position &root, int firstDepth, int maxDepth);
+
+	// The last completed depth's result (main thread)
+	const SearchResult &result() const { return m_result; }
+
+	uint64_t nodes() const { return m_nodes.load(std::memory_order_relaxed); }
+
+private:
+	// Searches the root at m_rootDepth, in a window around `previous` (the last depth's score) if
+	// aspiration windows are on, widening it until the score falls inside
+	int searchRoot(int previous);
+
+	// `nullAllowed` is false right after a null move, so that two are never made in a row
+	int search(int alpha, int beta, int depth, int ply, bool pvNode, bool nullAllowed = true);
+	int quiescence(int alpha, int beta, int ply);
+
+	// Sort scores for the moves of the current node (see the class comment), into `scores`
+	void scoreMoves(const MoveList &moves, int *scores, Move ttMove, int ply);
+
+	bool isCapture(const Move &move) const;
+	bool isRepetitionOrFifty() const;
+
+	// Counts a node. On the main thread, also stops the search once a node or time limit is
+	// reached (only from depth 2 on). Returns whether the search has been stopped
+	bool visitNode();
+	bool stopped() const;
+
+	Search &m_owner;
+	int m_id;
+	Position m_pos;
+
+	// Keys of the game before the root, then of each position on the current line
+	std::vector<uint64_t> m_keys;
+
+	// Only written by this thread; atomic so the main thread can add it up for the node limit
+	std::atomic<uint64_t> m_nodes;
+	int m_rootDepth;
+	SearchResult m_result;
+
+	Move m_killers[MAX_PLY][2];	 // Quiet moves that caused a cutoff at each ply
+	int m_history[2][64][64];	 // Cutoff counts of quiet moves by side, from and to
+	Move m_pv[MAX_PLY][MAX_PLY]; // Triangular PV table: m_pv[ply] is the line from that ply
+	int m_pvLength[MAX_PLY];
+};
+
+// A search from one root position, run by limits.threads threads at once (Lazy SMP): every
+// thread searches the whole tree, and they speed each other up through the shared
+// transposition table. Half the helpers run one depth ahead so the threads spread out.
+// The main thread's result is the answer
+class Search
+{
+public:
+	// `gameKeys` are the Zobrist keys of the positions before the root, oldest first, so that
+	// the search can see repetitions of earlier positions in the game
+	Search(TranspositionTable &table, const std::vector<uint64_t> &gameKeys = {});
+
+	// Called (on the main thread) after every completed depth with the result so far
+	void onIteration(std::function<void(const SearchResult &)> callback) { m_onIteration = std::move(callback); }
+
+	SearchResult run(const Position &root, const SearchLimits &limits);
+
+	// Most threads one search runs: a few per hardware thread, as more only share the same cores
+	static int maxThreads();
+
+private:
+	friend class SearchThread;
+
+	uint64_t totalNodes() const;
+
+	TranspositionTable &m_table;
+	std::vector<uint64_t> m_gameKeys;
+	SearchLimits m_limits;
+	std::function<void(const SearchResult &)> m_onIteration;
+	int64_t m_startMs;
+	std::atomic<bool> m_stop;
+	std::vector<std::unique_ptr<SearchThread>> m_threads;
+};
+
+#endif // SEARCH_H
@@ -0,0 +1,202 @@
+#include "Stats.h"
+
+#if defined(CHESS_STATS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#define CHESS_PERF_EVENTS
+#endif
+
+#if defined(CHESS_STATS) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif defined(CHESS_STATS)
+#include <chrono>
+#endif
+
+static const char *const STAT_NAMES[STAT_COUNT] = {
+	"getLegalMoves",
+	"getPawnMoves",
+	"getKnightMoves",
+	"getBishopMoves",
+	"getRookMoves",
+	"getQueenMoves",
+	"getKingMoves",
+	"isSquareAttacked",
+	"makeMove",
+	"getGameStatus",
+};
+
+const char *statName(StatId id)
+{
+	return STAT_NAMES[id];
+}
+
+#ifdef CHESS_STATS
+
+AtomicStatCounters g_stats[STAT_COUNT];
+std::atomic<bool> g_perfEvents(false);
+
+static uint64_t readTimestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+#ifdef CHESS_PERF_EVENTS
+
+// The three hardware counters of one thread, opened as a group so a single read returns all of them.
+// perf_event_open counts for the thread that opened it, so each thread has its own
+struct PerfGroup
+{
+	int fds[3] = {-1, -1, -1};
+	bool opened = false;
+
+	~PerfGroup()
+	{
+		for (int fd : fds)
+			if (fd != -1)
+				close(fd);
+	}
+
+	bool open()
+	{
+		if (opened)
+			return fds[0] != -1;
+		opened = true;
+
+		const uint64_t configs[3] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES};
+		for (int i = 0; i < 3; ++i)
+		{
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[i];
+			attr.read_format = PERF_FORMAT_GROUP;
+			attr.disabled = i == 0; // The group starts when its leader is enabled
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fds[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+			if (fds[i] == -1)
+			{
+				for (int &fd : fds)
+				{
+					if (fd != -1)
+						close(fd);
+					fd = -1;
+				}
+				return false;
+			}
+		}
+		ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		return true;
+	}
+
+	bool read(uint64_t counts[3])
+	{
+		uint64_t buffer[4]; // Number of counters, then their values
+		if (::read(fds[0], buffer, sizeof(buffer)) != sizeof(buffer))
+			return false;
+		counts[0] = buffer[1];
+		counts[1] = buffer[2];
+		counts[2] = buffer[3];
+		return true;
+	}
+};
+
+static thread_local PerfGroup t_perf;
+
+#endif // CHESS_PERF_EVENTS
+
+StatScope::StatScope(StatId id) : m_id(id), m_hw(false)
+{
+#ifdef CHESS_PERF_EVENTS
+	if (g_perfEvents.load(std::memory_order_relaxed) && t_perf.open())
+		m_hw = t_perf.read(m_hwStart);
+#endif
+	m_start = readTimestamp();
+}
+
+StatScope::~StatScope()
+{
+	uint64_t end = readTimestamp();
+	AtomicStatCounters &stats = g_stats[m_id];
+	stats.calls.fetch_add(1, std::memory_order_relaxed);
+	stats.cycles.fetch_add(end - m_start, std::memory_order_relaxed);
+#ifdef CHESS_PERF_EVENTS
+	uint64_t hwEnd[3];
+	if (m_hw && t_perf.read(hwEnd))
+	{
+		stats.hwCycles.fetch_add(hwEnd[0] - m_hwStart[0], std::memory_order_relaxed);
+		stats.instructions.fetch_add(hwEnd[1] - m_hwStart[1], std::memory_order_relaxed);
+		stats.branchMisses.fetch_add(hwEnd[2] - m_hwStart[2], std::memory_order_relaxed);
+	}
+#endif
+}
+
+bool statsCompiledIn()
+{
+	return true;
+}
+
+StatCounters getStats(StatId id)
+{
+	const AtomicStatCounters &stats = g_stats[id];
+	return {stats.calls.load(), stats.moves.load(), stats.rejected.load(), stats.cycles.load(),
+			stats.hwCycles.load(), stats.instructions.load(), stats.branchMisses.load()};
+}
+
+void resetStats()
+{
+	for (AtomicStatCounters &stats : g_stats)
+	{
+		stats.calls = 0;
+		stats.moves = 0;
+		stats.rejected = 0;
+		stats.cycles = 0;
+		stats.hwCycles = 0;
+		stats.instructions = 0;
+		stats.branchMisses = 0;
+	}
+}
+
+bool enablePerfEvents(bool enable)
+{
+#ifdef CHESS_PERF_EVENTS
+	// Try on this thread first, so the caller learns straight away if the kernel says no
+	if (enable && !t_perf.open())
+		return false;
+	g_perfEvents = enable;
+	return true;
+#else
+	return !enable;
+#endif
+}
+
+#else // Compiled out: nothing is ever counted
+
+bool statsCompiledIn()
+{
+	return false;
+}
+
+StatCounters getStats(StatId)
+{
+	return StatCounters();
+}
+
+void resetStats()
+{
+}
+
+bool enablePerfEvents(bool enable)
+{
+	return !enable;
+}
+
+#endif // CHESS_STATS
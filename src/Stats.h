@@ -0,0 +1,120 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+
+// Counters and timers on the engine's hot paths, to see where the time goes from inside a
+// running program instead of attaching a profiler. They are only compiled in when building
+// with -DCHESS_STATS. Otherwise the STAT_ macros are empty, the hot paths are exactly as
+// without them, and every counter reads zero
+
+// The instrumented functions. The per-piece entries count the generator for that piece type
+// wherever it runs: once per piece type inside every getLegalMoves (over all of the side's
+// pieces of that type), and once per direct get*Moves call. Castling counts as king moves
+enum StatId
+{
+	STAT_GET_LEGAL_MOVES,
+	STAT_GET_PAWN_MOVES,
+	STAT_GET_KNIGHT_MOVES,
+	STAT_GET_BISHOP_MOVES,
+	STAT_GET_ROOK_MOVES,
+	STAT_GET_QUEEN_MOVES,
+	STAT_GET_KING_MOVES,
+	STAT_IS_SQUARE_ATTACKED,
+	STAT_MAKE_MOVE,
+	STAT_GAME_STATUS,
+	STAT_COUNT
+};
+
+// Totals for one instrumented function since the last resetStats
+struct StatCounters
+{
+	uint64_t calls;
+	uint64_t moves;	   // Moves produced
+	uint64_t rejected; // Pseudo-legal moves dropped for leaving the king in check
+	uint64_t cycles;   // Time stamp counter ticks spent inside
+
+	// Hardware counts spent inside, from perf_event_open. Zero unless enablePerfEvents is on
+	uint64_t hwCycles;
+	uint64_t instructions;
+	uint64_t branchMisses;
+};
+
+// Name of the function a StatId counts, e.g. "getLegalMoves"
+const char *statName(StatId id);
+
+// Whether this build was made with -DCHESS_STATS
+bool statsCompiledIn();
+
+StatCounters getStats(StatId id);
+void resetStats();
+
+// Also read the CPU's cycle, instruction and branch-miss counters around every instrumented call
+// (Linux only, and each read is a system call, so expect the calls to get much slower).
+// Returns false if they cannot be read: stats compiled out, not Linux, or refused by the kernel
+// (see /proc/sys/kernel/perf_event_paranoid)
+bool enablePerfEvents(bool enable);
+
+#ifdef CHESS_STATS
+
+#include <atomic>
+
+// Shared by all threads, so the counters are atomics (relaxed: only the totals matter)
+struct AtomicStatCounters
+{
+	std::atomic<uint64_t> calls{0};
+	std::atomic<uint64_t> moves{0};
+	std::atomic<uint64_t> rejected{0};
+	std::atomic<uint64_t> cycles{0};
+	std::atomic<uint64_t> hwCycles{0};
+	std::atomic<uint64_t> instructions{0};
+	std::atomic<uint64_t> branchMisses{0};
+};
+
+extern AtomicStatCounters g_stats[STAT_COUNT];
+extern std::atomic<bool> g_perfEvents;
+
+// Counts a call and the time until the end of the enclosing block
+class StatScope
+{
+public:
+	explicit StatScope(StatId id);
+	~StatScope();
+
+protected:
+	StatId m_id;
+
+private:
+	uint64_t m_start;
+	uint64_t m_hwStart[3];
+	bool m_hw;
+};
+
+// Same, also counting the moves appended to a move list during the block
+template <typename List>
+class StatMovesScope : public StatScope
+{
+public:
+	StatMovesScope(StatId id, const List &moves) : StatScope(id), m_moves(moves), m_before(moves.size()) {}
+	~StatMovesScope() { g_stats[m_id].moves.fetch_add(uint64_t(m_moves.size() - m_before), std::memory_order_relaxed); }
+
+private:
+	const List &m_moves;
+	int m_before;
+};
+
+#define STAT_SCOPE(id) StatScope statScope(id)
+#define STAT_MOVES_SCOPE(id, moves) StatMovesScope statScope(id, moves)
+#define STAT_MOVES(id, n) g_stats[id].moves.fetch_add(uint64_t(n), std::memory_order_relaxed)
+#define STAT_REJECTED(id, n) g_stats[id].rejected.fetch_add(uint64_t(n), std::memory_order_relaxed)
+
+#else
+
+#define STAT_SCOPE(id) ((void)0)
+#define STAT_MOVES_SCOPE(id, moves) ((void)0)
+#define STAT_MOVES(id, n) ((void)0)
+#define STAT_REJECTED(id, n) ((void)0)
+
+#endif // CHESS_STATS
+
+#endif // STATS_H
@@ -0,0 +1,41 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Random numbers for Zobrist hashing. A position's key is the XOR of the numbers for
+// everything in it, so a move only has to XOR in and out what it changes
+struct ZobristKeys
+{
+	uint64_t pieceSquare[13][64]; // Indexed by piece + 6, since Piece runs from -6 (B_KING) to 6 (W_KING)
+	uint64_t castling[16];		  // One per combination of castling rights
+	uint64_t enPassantFile[8];
+	uint64_t blackToMove;
+
+	// Filled by the compiler from a fixed seed (splitmix64), so keys are the same on every run
+	constexpr ZobristKeys() : pieceSquare{}, castling{}, enPassantFile{}, blackToMove(0)
+	{
+		uint64_t state = 0x9E3779B97F4A7C15ULL;
+		for (int piece = 0; piece < 13; ++piece)
+			for (int sq = 0; sq < 64; ++sq)
+				pieceSquare[piece][sq] = next(state);
+		for (int rights = 0; rights < 16; ++rights)
+			castling[rights] = next(state);
+		for (int file = 0; file < 8; ++file)
+			enPassantFile[file] = next(state);
+		blackToMove = next(state);
+	}
+
+private:
+	static constexpr uint64_t next(uint64_t &state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+};
+
+inline constexpr ZobristKeys ZOBRIST;
+
+#endif // ZOBRIST_H
@@ -0,0 +1,178 @@
+// bench: times the calls a Python caller makes into the engine (move generation, attack tests,
+// making and undoing moves, game status, feature planes) over the positions in BenchPositions.h.
+// bench.py times the same calls through the Python module, so the two together separate the
+// engine's own cost from the binding overhead.
+//
+// Usage: bench [--fens] [--time <ms>]
+//   --fens  print the benchmark positions, one "name fen" per line, and exit
+//   --time  how long to run each benchmark, 200 ms by default
+
+#include "Board.h"
+#include "BenchPositions.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Results are added in here so the compiler cannot drop the calls being timed
+static volatile uint64_t g_sink;
+
+// A benchmark position with what the timed loops need worked out up front
+struct BenchBoard
+{
+	Board board;
+	std::vector<int> squares[7]; // Squares of the side to move's pieces, by piece type
+	std::vector<Move> moves;	 // Legal moves
+};
+
+// Runs `body` over every position, round after round, until `ms` milliseconds have passed.
+// body returns how many calls it made. NaN if a whole round made none (e.g. a piece type
+// that no position has)
+template <typename Body>
+static double nanosecondsPerCall(std::vector<BenchBoard> &boards, int ms, Body body)
+{
+	uint64_t calls = 0;
+	double seconds = 0;
+	auto start = std::chrono::steady_clock::now();
+	do
+	{
+		for (BenchBoard &b : boards)
+			calls += body(b);
+		if (!calls)
+			return std::nan("");
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (seconds * 1000 < ms);
+	return seconds * 1e9 / calls;
+}
+
+static void report(const char *name, double ns)
+{
+	std::printf("%-24s %10.1f ns/call\n", name, ns);
+}
+
+int main(int argc, char **argv)
+{
+	int ms = 200;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--fens"))
+		{
+			for (const BenchPosition &pos : BENCH_POSITIONS)
+				std::printf("%s %s\n", pos.name, pos.fen);
+			return 0;
+		}
+		else if (!std::strcmp(argv[i], "--time") && i + 1 < argc)
+			ms = std::atoi(argv[++i]);
+		else
+		{
+			std::fprintf(stderr, "usage: bench [--fens] [--time <ms>]\n");
+			return 1;
+		}
+	}
+
+	std::vector<BenchBoard> boards(BENCH_POSITION_COUNT);
+	for (int i = 0; i < BENCH_POSITION_COUNT; ++i)
+	{
+		BenchBoard &b = boards[i];
+		if (!b.board.setFen(BENCH_POSITIONS[i].fen))
+		{
+			std::fprintf(stderr, "bench: invalid FEN of %s\n", BENCH_POSITIONS[i].name);
+			return 1;
+		}
+		std::vector<std::vector<int>> state = b.board.getBoardState();
+		int side = b.board.isWhiteToMove() ? 1 : -1;
+		for (int sq = 0; sq < 64; ++sq)
+		{
+			int piece = state[rowOf(sq)][colOf(sq)] * side;
+			if (piece > 0)
+				b.squares[piece].push_back(sq);
+		}
+		b.moves = b.board.getLegalMoves();
+	}
+
+	report("getLegalMoves(MoveList)", nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+		   {
+			   MoveList moves;
+			   b.board.getLegalMoves(moves);
+			   g_sink += moves.size();
+			   return 1; }));
+
+	report("getLegalMoves(vector)", nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+		   {
+			   g_sink += b.board.getLegalMoves().size();
+			   return 1; }));
+
+	// One call per piece of that type belonging to the side to move
+	struct Generator
+	{
+		const char *name;
+		int pieceType;
+		void (Position::*generate)(int, int, MoveList &);
+	};
+	const Generator generators[] = {
+		{"getPawnMoves", W_PAWN, &Position::getPawnMoves},
+		{"getKnightMoves", W_KNIGHT, &Position::getKnightMoves},
+		{"getBishopMoves", W_BISHOP, &Position::getBishopMoves},
+		{"getRookMoves", W_ROOK, &Position::getRookMoves},
+		{"getQueenMoves", W_QUEEN, &Position::getQueenMoves},
+		{"getKingMoves", W_KING, &Position::getKingMoves},
+	};
+	for (const Generator &gen : generators)
+	{
+		report(gen.name, nanosecondsPerCall(boards, ms, [&gen](BenchBoard &b)
+			   {
+				   MoveList moves;
+				   for (int sq : b.squares[gen.pieceType])
+				   {
+					   moves.clear();
+					   (b.board.*gen.generate)(rowOf(sq), colOf(sq), moves);
+					   g_sink += moves.size();
+				   }
+				   return int(b.squares[gen.pieceType].size()); }));
+	}
+
+	// Every square, attacked by the side not to move
+	report("isSquareAttacked", nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+		   {
+			   bool byWhite = !b.board.isWhiteToMove();
+			   for (int sq = 0; sq < 64; ++sq)
+				   g_sink += b.board.isSquareAttacked(rowOf(sq), colOf(sq), byWhite);
+			   return 64; }));
+
+	// A pair per legal move, as Python plays one move and takes it back
+	report("makeMove+undoMove", nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+		   {
+			   for (const Move &move : b.moves)
+			   {
+				   b.board.makeMove(move);
+				   b.board.undoMove();
+			   }
+			   return int(b.moves.size()); }));
+
+	// The status is cached per position, so an undo and redo in between makes every call
+	// work it out again. Their cost is timed on its own and taken off
+	for (BenchBoard &b : boards)
+		b.board.makeMove(b.moves[0]);
+	double undoRedo = nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+										 {
+											 b.board.undoMove();
+											 b.board.redoMove();
+											 return 1; });
+	double withStatus = nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+										   {
+											   b.board.undoMove();
+											   b.board.redoMove();
+											   g_sink += b.board.getGameStatus();
+											   return 1; });
+	report("getGameStatus", withStatus - undoRedo);
+	report("undoMove+redoMove", undoRedo);
+
+	report("getFeaturePlanes", nanosecondsPerCall(boards, ms, [](BenchBoard &b)
+		   {
+			   g_sink += b.board.getFeaturePlanes().size();
+			   return 1; }));
+
+	return 0;
+}
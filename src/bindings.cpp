@@ -1,9 +1,48 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include "Board.h"
+#include "Stats.h"
 
 namespace py = pybind11;
 
+// The engine trusts a Move to hold squares on the board and a known flag, so moves coming
+// from Python are checked here and a bad one raises ValueError
+static Move moveFromInt(uint16_t data)
+{
+	if (!Move::isValidEncoding(data))
+		throw py::value_error("not an encoded move: flag " + std::to_string(data >> 12) + " is unused");
+	return Move::fromEncoded(data);
+}
+
+static void checkSquare(int row, int col)
+{
+	if (row < 0 || row > 7 || col < 0 || col > 7)
+		throw py::value_error("rows and columns run from 0 to 7");
+}
+
+static Move moveFromRowsAndCols(int fr, int fc, int tr, int tc, int pp)
+{
+	checkSquare(fr, fc);
+	checkSquare(tr, tc);
+	int type = pp < 0 ? -pp : pp;
+	if (pp != EMPTY && (type < W_KNIGHT || type > W_QUEEN))
+		throw py::value_error("can only promote to a knight, bishop, rook or queen");
+	return Move(fr, fc, tr, tc, pp);
+}
+
+// A get*Moves generator, with the square checked since the generators index the board with it.
+// They append without a capacity check, so the list must have room for the most moves the
+// piece can have (MaxMoves) or IndexError is raised
+template <void (Position::*Generate)(int, int, MoveList &), int MaxMoves>
+static void generateMoves(Board &board, int row, int col, MoveList &moves)
+{
+	checkSquare(row, col);
+	if (moves.size() + MaxMoves > MoveList::MAX_MOVES)
+		throw py::index_error("MoveList is full; clear() it before generating more moves");
+	(board.*Generate)(row, col, moves);
+}
+
 PYBIND11_MODULE(chess, m)
 {
 	m.doc() = "A fast C++ chess engine for Python";
@@ -15,21 +54,68 @@ PYBIND11_MODULE(chess, m)
 		.value("BLACK_WINS_CHECKMATE", GameStatus::BLACK_WINS_CHECKMATE)
 		.value("DRAW_STALEMATE", GameStatus::DRAW_STALEMATE)
 		.value("DRAW_INSUFFICIENT_MATERIAL", GameStatus::DRAW_INSUFFICIENT_MATERIAL)
+		.value("DRAW_THREEFOLD_REPETITION", GameStatus::DRAW_THREEFOLD_REPETITION)
+		.value("DRAW_FIFTY_MOVE", GameStatus::DRAW_FIFTY_MOVE)
 		.export_values(); // Make the enum values available at module level
 
+	// Which kind of legal moves to generate (captures and promotions, quiet moves, checks, all)
+	py::enum_<MoveGenType>(m, "MoveGenType")
+		.value("CAPTURES_AND_PROMOTIONS", MoveGenType::CAPTURES_AND_PROMOTIONS)
+		.value("QUIET_MOVES", MoveGenType::QUIET_MOVES)
+		.value("CHECKING_MOVES", MoveGenType::CHECKING_MOVES)
+		.value("ALL_MOVES", MoveGenType::ALL_MOVES)
+		.export_values();
+
 	// Bind the Move struct so Python can see it
 	py::class_<Move>(m, "Move")
 
 		// Expose the two constructors we made
-		.def(py::init<int, int, int, int>())
-		.def(py::init<int, int, int, int, int>())
+		.def(py::init([](int fr, int fc, int tr, int tc)
+					  { return moveFromRowsAndCols(fr, fc, tr, tc, EMPTY); }))
+		.def(py::init(&moveFromRowsAndCols))
+
+		// Moves also travel as plain 16-bit integers (see get_legal_moves_encoded)
+		.def_static("from_int", &moveFromInt)
+		.def("__int__", &Move::encoded)
+		.def("__eq__", &Move::operator==)
+		.def("__hash__", &Move::encoded)
 
 		// Make the members readable from python
-		.def_readonly("from_row", &Move::from_row)
-		.def_readonly("from_col", &Move::from_col)
-		.def_readonly("to_row", &Move::to_row)
-		.def_readonly("to_col", &Move::to_col)
-		.def_readonly("promotion_piece", &Move::promotion_piece);
+		.def_property_readonly("from_row", &Move::fromRow)
+		.def_property_readonly("from_col", &Move::fromCol)
+		.def_property_readonly("to_row", &Move::toRow)
+		.def_property_readonly("to_col", &Move::toCol)
+		.def_property_readonly("promotion_piece", &Move::promotionPiece);
+
+	// Reusable move buffer, so Python callers can also generate moves without allocating a new list
+	py::class_<MoveList>(m, "MoveList")
+		.def(py::init<>())
+		.def("__len__", &MoveList::size)
+		.def("clear", &MoveList::clear)
+		.def("__getitem__", [](const MoveList &moves, int i)
+			 {
+				 if (i < 0 || i >= moves.size())
+					 throw py::index_error();
+				 return moves[i];
+			 })
+		.def("__iter__", [](const MoveList &moves)
+			 { return py::make_iterator(moves.begin(), moves.end()); },
+			 py::keep_alive<0, 1>());
+
+	// What board.search returns. Scores beyond VALUE_MATE_IN_MAX_PLY (either sign) are forced mates
+	py::class_<SearchResult>(m, "SearchResult")
+		.def_readonly("best_move", &SearchResult::bestMove)
+		.def_readonly("score", &SearchResult::score)
+		.def_readonly("depth", &SearchResult::depth)
+		.def_readonly("nodes", &SearchResult::nodes)
+		.def_readonly("pv", &SearchResult::pv);
+	m.attr("VALUE_MATE") = VALUE_MATE;
+
+	// Held by shared_ptr so that boards can share one: each table is allocated and zeroed in full
+	py::class_<TranspositionTable, std::shared_ptr<TranspositionTable>>(m, "TranspositionTable")
+		.def(py::init<size_t>(), py::arg("megabytes") = 16)
+		.def("clear", &TranspositionTable::clear);
+	m.attr("VALUE_MATE_IN_MAX_PLY") = VALUE_MATE_IN_MAX_PLY;
 
 	// Bind the main Board class
 	py::class_<Board>(m, "Board")
@@ -37,17 +123,132 @@ PYBIND11_MODULE(chess, m)
 
 		// Expose all the public methods we want Python to use
 		.def("print", &Board::print)
-		.def("makeMove", &Board::makeMove)
-		.def("getLegalMoves", &Board::getLegalMoves)
+		.def("clone", &Board::clone)
+		.def("set_fen", &Board::setFen)
+		.def("makeMove", py::overload_cast<const Move &>(&Board::makeMove))
+		.def("tryMakeMove", &Board::tryMakeMove)
+		.def("isLegal", &Board::isLegal)
+		.def("getLegalMoves", py::overload_cast<>(&Board::getLegalMoves))
+		.def("getLegalMoves", py::overload_cast<MoveList &>(&Board::getLegalMoves))
+		.def("getLegalMoves", py::overload_cast<MoveGenType>(&Board::getLegalMoves))
+		.def("getLegalMoves", py::overload_cast<MoveList &, MoveGenType>(&Board::getLegalMoves))
+
+		// Pseudo-legal moves of the piece on (row, col), appended to the MoveList. The numbers
+		// are the most moves each piece can have (a pawn: three targets times four promotions)
+		.def("getPawnMoves", &generateMoves<&Position::getPawnMoves, 12>)
+		.def("getKnightMoves", &generateMoves<&Position::getKnightMoves, 8>)
+		.def("getBishopMoves", &generateMoves<&Position::getBishopMoves, 13>)
+		.def("getRookMoves", &generateMoves<&Position::getRookMoves, 14>)
+		.def("getQueenMoves", &generateMoves<&Position::getQueenMoves, 27>)
+		.def("getKingMoves", &generateMoves<&Position::getKingMoves, 10>)
+		.def("givesCheck", &Board::givesCheck)
+		.def("see", &Board::see)
 		.def("isKingInCheck", &Board::isKingInCheck)
-		.def("isSquareAttacked", &Board::isSquareAttacked)
+		.def("isSquareAttacked", [](Board &board, int row, int col, bool byWhite)
+			 {
+				 checkSquare(row, col);
+				 return board.isSquareAttacked(row, col, byWhite);
+			 })
 		.def("is_white_to_move", &Board::isWhiteToMove)
+		.def("hash", &Board::hash)
+		.def("get_piece_count", [](const Board &board, int piece)
+			 {
+				 if (piece < B_KING || piece > W_KING)
+					 throw py::value_error("piece must be from -6 (black king) to 6 (white king)");
+				 return board.getPieceCount(piece);
+			 })
+		.def("get_material", &Board::getMaterial)
 		.def("get_board_state", &Board::getBoardState)
 		.def("get_game_status", &Board::getGameStatus)
+		.def("get_halfmove_clock", &Board::getHalfmoveClock)
+		.def("get_repetition_count", &Board::getRepetitionCount)
 		.def("undoMove", &Board::undoMove)
 		.def("redoMove", &Board::redoMove)
+		.def("go_to_ply", &Board::goToPly)
+		.def("get_ply", &Board::getPly)
+		.def("get_history_length", &Board::getHistoryLength)
+		.def("get_table", &Board::table)
+		.def("set_table", &Board::setTable, py::arg("table"))
+		// Zero means no limit (see SearchLimits); threads > 1 searches in parallel (Lazy SMP), up
+		// to chess.max_search_threads(). Negative limits raise ValueError.
+		// The flags after it turn parts of the selective search on or off (see SearchOptions).
+		// The position, game keys and table are taken while holding the GIL, which is only
+		// released for the search itself, so other Python threads can keep using the board
+		.def("search", [](Board &board, int depth, uint64_t nodes, int movetimeMs, int threads,
+						  bool nullMove, bool lmr, bool futility, bool reverseFutility, bool aspiration)
+			 {
+				 if (depth < 0 || movetimeMs < 0)
+					 throw py::value_error("depth and movetime_ms must not be negative");
+				 if (threads < 1 || threads > Search::maxThreads())
+					 throw py::value_error("threads must be between 1 and " + std::to_string(Search::maxThreads()));
+				 SearchLimits limits;
+				 limits.depth = depth;
+				 limits.nodes = nodes;
+				 limits.movetimeMs = movetimeMs;
+				 limits.threads = threads;
+				 limits.options.nullMove = nullMove;
+				 limits.options.lmr = lmr;
+				 limits.options.futility = futility;
+				 limits.options.reverseFutility = reverseFutility;
+				 limits.options.aspiration = aspiration;
+
+				 Position root = board;
+				 std::vector<uint64_t> keys = board.gameKeys();
+				 std::shared_ptr<TranspositionTable> table = board.table();
+				 py::gil_scoped_release release;
+				 return Search(*table, keys).run(root, limits);
+			 },
+			 py::arg("depth") = 0, py::arg("nodes") = 0, py::arg("movetime_ms") = 0, py::arg("threads") = 1,
+			 py::arg("null_move") = true, py::arg("lmr") = true, py::arg("futility") = true,
+			 py::arg("reverse_futility") = true, py::arg("aspiration") = true)
 		.def("getWhiteCaptured", &Board::getWhiteCaptured)
 		.def("getBlackCaptured", &Board::getBlackCaptured)
-		.def("get_feature_planes", &Board::getFeaturePlanes);
+		.def("get_feature_planes", &Board::getFeaturePlanes)
+
+		// Legal moves as a numpy uint16 array of encoded moves, so no Python object is made per move
+		.def("get_legal_moves_encoded", [](Board &board, MoveGenType type)
+			 {
+				 MoveList moves;
+				 board.getLegalMoves(moves, type);
+				 py::array_t<uint16_t> encoded(moves.size());
+				 uint16_t *out = encoded.mutable_data();
+				 for (int i = 0; i < moves.size(); ++i)
+					 out[i] = moves[i].encoded();
+				 return encoded;
+			 },
+			 py::arg("type") = ALL_MOVES)
+		// Plays an encoded move, raising ValueError (and leaving the board alone) unless it is legal
+		.def("make_move_encoded", [](Board &board, uint16_t move)
+			 {
+				 if (!board.tryMakeMove(moveFromInt(move)))
+					 throw py::value_error("illegal move " + moveFromInt(move).uci());
+			 })
+
+		// Hot-path counters (see Stats.h) as {function name: {counter: value}}. They are shared by
+		// all boards, and all zero unless the module was built with -DCHESS_STATS
+		.def("stats", [](const Board &)
+			 {
+				 py::dict stats;
+				 for (int id = 0; id < STAT_COUNT; ++id)
+				 {
+					 StatCounters c = getStats(StatId(id));
+					 py::dict counters;
+					 counters["calls"] = c.calls;
+					 counters["moves"] = c.moves;
+					 counters["rejected"] = c.rejected;
+					 counters["cycles"] = c.cycles;
+					 counters["hw_cycles"] = c.hwCycles;
+					 counters["instructions"] = c.instructions;
+					 counters["branch_misses"] = c.branchMisses;
+					 stats[statName(StatId(id))] = counters;
+				 }
+				 return stats;
+			 });
+
+	m.def("reset_stats", &resetStats, "Set every hot-path counter back to zero");
+	m.def("stats_compiled_in", &statsCompiledIn, "Whether the module was built with -DCHESS_STATS");
+	m.def("enable_perf_events", &enablePerfEvents, py::arg("enable") = true,
+		  "Also count CPU cycles, instructions and branch misses per call (Linux). Returns False if unavailable");
+	m.def("max_search_threads", &Search::maxThreads, "Most threads Board.search accepts");
 
 }
@@ -1,7 +1,14 @@
 #include "Board.h"
+#include "BenchPositions.h"
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <iomanip>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 // Helper function to print moves
 void printMoves(const std::vector<Move>& moves) {
@@ -11,12 +18,261 @@ void printMoves(const std::vector<Move>& moves) {
 	}
 
 	for (const Move& move : moves) {
-		std::cout << " Move from (" <<move.from_row << "," << move.from_col << ")" << " to (" << move.to_row << ","
-		<< move.to_col << ")" << std::endl;
+		std::cout << " Move from (" <<move.fromRow() << "," << move.fromCol() << ")" << " to (" << move.toRow() << ","
+		<< move.toCol() << ")" << std::endl;
 	}
 }
 
-int main() {
+// Leaf nodes of the legal move tree to `depth`, counting the last ply in bulk
+static uint64_t countNodes(Position& pos, int depth) {
+	MoveList moves;
+	pos.getLegalMoves(moves);
+	if (depth <= 1)
+		return depth == 1 ? moves.size() : 1;
+
+	uint64_t nodes = 0;
+	for (const Move& move : moves) {
+		UndoInfo undo;
+		pos.makeMove(move, undo);
+		nodes += countNodes(pos, depth - 1);
+		pos.unmakeMove(move, undo);
+	}
+	return nodes;
+}
+
+// --no-null-move, --no-lmr, --no-futility, --no-reverse-futility, --no-aspiration turn off
+// one part of the selective search (see SearchOptions). Returns false for any other argument
+static bool parseSearchOption(const char* arg, SearchOptions& options) {
+	if (!std::strcmp(arg, "--no-null-move"))
+		options.nullMove = false;
+	else if (!std::strcmp(arg, "--no-lmr"))
+		options.lmr = false;
+	else if (!std::strcmp(arg, "--no-futility"))
+		options.futility = false;
+	else if (!std::strcmp(arg, "--no-reverse-futility"))
+		options.reverseFutility = false;
+	else if (!std::strcmp(arg, "--no-aspiration"))
+		options.aspiration = false;
+	else
+		return false;
+	return true;
+}
+
+// Totals of a search over all the bench positions
+struct SearchBenchResult {
+	double seconds = 0;
+	uint64_t nodes = 0;
+	uint64_t previousNodes = 0; // Nodes it took to finish the depth before the depth limit
+	int depths = 0;				// Depths reached, added up
+};
+
+// Searches every bench position within `limits`, each from an empty transposition table
+static SearchBenchResult searchBench(const SearchLimits& limits) {
+	TranspositionTable table;
+	SearchBenchResult total;
+	for (int i = 0; i < BENCH_POSITION_COUNT; ++i) {
+		Position pos;
+		pos.setFen(BENCH_POSITIONS[i].fen);
+		table.clear();
+		Search search(table);
+		search.onIteration([&](const SearchResult& result) {
+			if (result.depth == limits.depth - 1)
+				total.previousNodes += result.nodes;
+		});
+		auto start = std::chrono::steady_clock::now();
+		SearchResult result = search.run(pos, limits);
+		total.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		total.nodes += result.nodes;
+		total.depths += result.depth;
+	}
+	return total;
+}
+
+// bench [depth] [--search-depth D] [--search-nodes N] [--threads T] [--no-...] [--json <file>]
+// Counts nodes to a fixed depth over the positions in BenchPositions.h. The total is the
+// signature: it only changes when move generation behaves differently, never with speed.
+// Nodes per second is the speed. Then the same positions are searched on one thread, to D
+// (8 by default) or, given a node budget, until each has used N nodes (to no fixed depth
+// unless D is given too). The search's node count is a second signature, and the depth
+// reached the measure of how far it sees. With a depth limit, the nodes for depth D over
+// those for D - 1 are the effective branching factor, which the --no- options (see
+// parseSearchOption) show each pruning's share of, and with T threads the positions are
+// searched again, the time against one thread being the speedup. --search-depth 0 without
+// a node budget skips the search. --json also writes all of it, for bench_compare.py
+static int runBench(int argc, char** argv) {
+	int depth = 4;
+	SearchLimits limits;
+	limits.depth = 8;
+	bool depthGiven = false;
+	int threads = 1;
+	const char* jsonPath = nullptr;
+	for (int i = 2; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--search-depth") && i + 1 < argc) {
+			limits.depth = std::max(0, std::atoi(argv[++i]));
+			depthGiven = true;
+		} else if (!std::strcmp(argv[i], "--search-nodes") && i + 1 < argc)
+			limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = std::clamp(std::atoi(argv[++i]), 1, Search::maxThreads());
+		else if (parseSearchOption(argv[i], limits.options))
+			continue;
+		else if (std::atoi(argv[i]) > 0)
+			depth = std::atoi(argv[i]);
+		else {
+			std::cerr << "usage: chess_engine bench [depth] [--search-depth D] [--search-nodes N] [--threads T] [--no-null-move]"
+						 " [--no-lmr] [--no-futility] [--no-reverse-futility] [--no-aspiration] [--json <file>]" << std::endl;
+			return 1;
+		}
+	}
+	if (limits.nodes && !depthGiven)
+		limits.depth = 0;
+	bool searching = limits.depth > 0 || limits.nodes > 0;
+
+	std::vector<uint64_t> nodes(BENCH_POSITION_COUNT);
+	std::vector<double> seconds(BENCH_POSITION_COUNT);
+	uint64_t totalNodes = 0;
+	double totalSeconds = 0;
+	for (int i = 0; i < BENCH_POSITION_COUNT; ++i) {
+		Position pos;
+		pos.setFen(BENCH_POSITIONS[i].fen);
+		auto start = std::chrono::steady_clock::now();
+		nodes[i] = countNodes(pos, depth);
+		seconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		totalNodes += nodes[i];
+		totalSeconds += seconds[i];
+		std::cout << std::left << std::setw(20) << BENCH_POSITIONS[i].name << std::right << std::setw(12) << nodes[i] << std::endl;
+	}
+
+	double nps = totalSeconds > 0 ? totalNodes / totalSeconds : 0;
+	std::cout << "\nDepth: " << depth << std::endl;
+	std::cout << "Signature: " << totalNodes << std::endl;
+	std::cout << "Time: " << std::fixed << std::setprecision(3) << totalSeconds << " s" << std::endl;
+	std::cout << "Nodes/second: " << std::setprecision(0) << nps << std::endl;
+
+	SearchBenchResult search, parallel;
+	double branching = 0, averageDepth = 0;
+	if (searching) {
+		search = searchBench(limits);
+		averageDepth = double(search.depths) / BENCH_POSITION_COUNT;
+		std::cout << std::endl;
+		if (limits.depth)
+			std::cout << "Search depth: " << limits.depth << std::endl;
+		if (limits.nodes)
+			std::cout << "Search nodes per position: " << limits.nodes << std::endl;
+		std::cout << "Search signature: " << search.nodes << std::endl;
+		std::cout << "Search time: " << std::setprecision(3) << search.seconds << " s" << std::endl;
+		std::cout << "Search nodes/second: " << std::setprecision(0) << search.nodes / search.seconds << std::endl;
+		std::cout << "Average depth reached: " << std::setprecision(2) << averageDepth << std::endl;
+		if (limits.depth && search.previousNodes) {
+			branching = double(search.nodes) / search.previousNodes;
+			std::cout << "Effective branching factor: " << std::setprecision(2) << branching << std::endl;
+		}
+		if (limits.depth && threads > 1) {
+			limits.threads = threads;
+			parallel = searchBench(limits);
+			std::cout << "Threads: " << threads << ", time: " << std::setprecision(3) << parallel.seconds
+					  << " s, speedup: " << std::setprecision(2) << search.seconds / parallel.seconds << std::endl;
+		}
+	}
+
+	if (jsonPath) {
+		std::ofstream json(jsonPath);
+		if (!json) {
+			std::cerr << "bench: cannot write " << jsonPath << std::endl;
+			return 1;
+		}
+		json << std::fixed << "{\n  \"depth\": " << depth << ",\n  \"signature\": " << totalNodes
+			 << ",\n  \"seconds\": " << std::setprecision(6) << totalSeconds
+			 << ",\n  \"nps\": " << std::setprecision(0) << nps << ",\n";
+		if (searching) {
+			// Everything the search signature depends on, so that bench_compare.py can tell runs
+			// made with different settings from a change in the engine
+			const SearchOptions& options = limits.options;
+			json << "  \"search\": {\"depth\": " << limits.depth << ", \"nodes_limit\": " << limits.nodes
+				 << ", \"threads\": " << threads << ",\n    \"options\": {\"null_move\": " << std::boolalpha << options.nullMove
+				 << ", \"lmr\": " << options.lmr << ", \"futility\": " << options.futility
+				 << ", \"reverse_futility\": " << options.reverseFutility
+				 << ", \"aspiration\": " << options.aspiration << std::noboolalpha
+				 << "},\n    \"signature\": " << search.nodes
+				 << ", \"seconds\": " << std::setprecision(6) << search.seconds
+				 << ", \"nps\": " << std::setprecision(0) << search.nodes / search.seconds
+				 << ", \"average_depth\": " << std::setprecision(3) << averageDepth;
+			if (branching)
+				json << ", \"branching\": " << std::setprecision(3) << branching;
+			if (parallel.seconds)
+				json << ", \"parallel_seconds\": " << std::setprecision(6) << parallel.seconds
+					 << ", \"speedup\": " << std::setprecision(3) << search.seconds / parallel.seconds;
+			json << "},\n";
+		}
+		json << "  \"positions\": [\n";
+		for (int i = 0; i < BENCH_POSITION_COUNT; ++i) {
+			json << "    {\"name\": \"" << BENCH_POSITIONS[i].name << "\", \"nodes\": " << nodes[i]
+				 << ", \"seconds\": " << std::setprecision(6) << seconds[i] << "}"
+				 << (i + 1 < BENCH_POSITION_COUNT ? ",\n" : "\n");
+		}
+		json << "  ]\n}\n";
+	}
+	return 0;
+}
+
+// search [--depth N] [--nodes N] [--movetime MS] [--threads N] [--hash MB] [--no-...] [--fen FEN]
+// Searches the start position (or the FEN) with a transposition table of MB megabytes (16 by
+// default) and prints a line per completed depth, then the best move
+static int runSearch(int argc, char** argv) {
+	SearchLimits limits;
+	std::string fen;
+	size_t hashMegabytes = 16;
+	for (int i = 2; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--depth") && i + 1 < argc)
+			limits.depth = std::atoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--nodes") && i + 1 < argc)
+			limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--movetime") && i + 1 < argc)
+			limits.movetimeMs = std::atoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+			limits.threads = std::atoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--hash") && i + 1 < argc)
+			hashMegabytes = std::strtoul(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--fen") && i + 1 < argc)
+			fen = argv[++i];
+		else if (!parseSearchOption(argv[i], limits.options)) {
+			std::cerr << "usage: chess_engine search [--depth N] [--nodes N] [--movetime MS] [--threads N] [--hash MB]"
+						 " [--no-null-move] [--no-lmr] [--no-futility] [--no-reverse-futility] [--no-aspiration] [--fen FEN]" << std::endl;
+			return 1;
+		}
+	}
+
+	Board board;
+	if (!fen.empty() && !board.setFen(fen)) {
+		std::cerr << "search: invalid FEN \"" << fen << "\"" << std::endl;
+		return 1;
+	}
+
+	TranspositionTable table(hashMegabytes);
+	Search search(table);
+	auto start = std::chrono::steady_clock::now();
+	search.onIteration([&](const SearchResult& result) {
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "depth " << result.depth << " score " << result.score << " nodes " << result.nodes
+				  << " time " << int(ms) << " pv";
+		for (const Move& move : result.pv)
+			std::cout << " " << move.uci();
+		std::cout << std::endl;
+	});
+	SearchResult result = search.run(board, limits);
+	// "0000" is the UCI way of saying there is no move (mate or stalemate)
+	std::cout << "bestmove " << (result.depth ? result.bestMove.uci() : "0000") << std::endl;
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1 && !std::strcmp(argv[1], "bench"))
+		return runBench(argc, argv);
+	if (argc > 1 && !std::strcmp(argv[1], "search"))
+		return runSearch(argc, argv);
+
 	std::cout << "Welcome to your C++ Chess Engine!" << std::endl;
 
 	Board myBoard; // Call the constructor and sets up the pieces
@@ -45,10 +301,10 @@ int main() {
 	Move en_passant_move = Move{7, 4, 7, 6}; // e1 to g1
 
 	for (const Move& move: legalMoves) {
-		if (move.from_row == en_passant_move.from_row &&
-			move.to_row == en_passant_move.to_row &&
-			move.from_col == en_passant_move.from_col &&
-			move.to_col == en_passant_move.to_col) {
+		if (move.fromRow() == en_passant_move.fromRow() &&
+			move.toRow() == en_passant_move.toRow() &&
+			move.fromCol() == en_passant_move.fromCol() &&
+			move.toCol() == en_passant_move.toCol()) {
 				found_castle_move = true;
 				break;
 				}
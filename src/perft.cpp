@@ -0,0 +1,194 @@
+// perft: counts the leaf nodes of the legal move tree to a given depth.
+// The counts for well-known positions are published, so this is how the move generator is
+// checked after a change, and the nodes per second are how its speed is measured.
+//
+// Usage: perft <depth> [--fen "<fen>"] [--divide] [--hash <MB>] [--threads <n>] [--no-bulk]
+//   --fen      start from this position instead of the initial one
+//   --divide   also print the count below each root move
+//   --hash     cache subtree counts in a table of this many megabytes
+//   --threads  split the root moves across this many threads
+//   --no-bulk  play out the last ply instead of counting the generated moves
+
+#include "Position.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Subtree counts keyed by position and depth, shared by all threads without locks.
+// An entry keeps key ^ data next to data, so a torn write fails the check and reads as a miss
+class PerftTable
+{
+public:
+	explicit PerftTable(size_t megabytes)
+	{
+		size_t count = 1;
+		while (count * 2 * sizeof(Entry) <= megabytes << 20)
+			count *= 2;
+		m_entries.reset(new Entry[count]);
+		m_mask = count - 1;
+	}
+
+	bool probe(uint64_t key, int depth, uint64_t &nodes) const
+	{
+		const Entry &entry = m_entries[key & m_mask];
+		uint64_t data = entry.data.load(std::memory_order_relaxed);
+		if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || int(data & 0xFF) != depth)
+			return false;
+		nodes = data >> 8;
+		return true;
+	}
+
+	void store(uint64_t key, int depth, uint64_t nodes)
+	{
+		Entry &entry = m_entries[key & m_mask];
+		uint64_t data = nodes << 8 | uint64_t(depth);
+		entry.check.store(key ^ data, std::memory_order_relaxed);
+		entry.data.store(data, std::memory_order_relaxed);
+	}
+
+private:
+	struct Entry
+	{
+		std::atomic<uint64_t> check{0};
+		std::atomic<uint64_t> data{0};
+	};
+
+	std::unique_ptr<Entry[]> m_entries;
+	size_t m_mask;
+};
+
+struct PerftOptions
+{
+	bool bulk = true;
+	PerftTable *table = nullptr;
+};
+
+static uint64_t perft(Position &pos, int depth, const PerftOptions &options)
+{
+	if (depth == 0)
+		return 1;
+
+	uint64_t nodes = 0;
+	if (options.table && depth >= 2 && options.table->probe(pos.hash(), depth, nodes))
+		return nodes;
+
+	MoveList moves;
+	pos.getLegalMoves(moves);
+
+	// Bulk counting: every legal move at the last ply is one leaf, no need to play them
+	if (depth == 1 && options.bulk)
+		return moves.size();
+
+	for (const Move &move : moves)
+	{
+		UndoInfo undo;
+		pos.makeMove(move, undo);
+		nodes += perft(pos, depth - 1, options);
+		pos.unmakeMove(move, undo);
+	}
+
+	if (options.table && depth >= 2)
+		options.table->store(pos.hash(), depth, nodes);
+	return nodes;
+}
+
+static int usage()
+{
+	std::fprintf(stderr, "usage: perft <depth> [--fen \"<fen>\"] [--divide] [--hash <MB>] [--threads <n>] [--no-bulk]\n");
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+		return usage();
+
+	int depth = std::atoi(argv[1]);
+	std::string fen;
+	bool divide = false;
+	size_t hashMegabytes = 0;
+	int threadCount = 1;
+	PerftOptions options;
+
+	for (int i = 2; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--fen") && i + 1 < argc)
+			fen = argv[++i];
+		else if (!std::strcmp(argv[i], "--divide"))
+			divide = true;
+		else if (!std::strcmp(argv[i], "--hash") && i + 1 < argc)
+			hashMegabytes = std::strtoul(argv[++i], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+			threadCount = std::atoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--no-bulk"))
+			options.bulk = false;
+		else
+			return usage();
+	}
+	if (depth < 1 || threadCount < 1)
+		return usage();
+
+	Position root;
+	if (!fen.empty() && !root.setFen(fen))
+	{
+		std::fprintf(stderr, "perft: invalid FEN \"%s\"\n", fen.c_str());
+		return 1;
+	}
+
+	std::unique_ptr<PerftTable> table;
+	if (hashMegabytes > 0)
+	{
+		table.reset(new PerftTable(hashMegabytes));
+		options.table = table.get();
+	}
+
+	MoveList rootMoves;
+	root.getLegalMoves(rootMoves);
+	std::vector<uint64_t> counts(rootMoves.size(), 0);
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Each thread takes the next unclaimed root move and searches it on its own copy of the position
+	std::atomic<int> nextMove(0);
+	auto worker = [&]()
+	{
+		Position pos = root;
+		for (int i = nextMove++; i < rootMoves.size(); i = nextMove++)
+		{
+			UndoInfo undo;
+			pos.makeMove(rootMoves[i], undo);
+			counts[i] = perft(pos, depth - 1, options);
+			pos.unmakeMove(rootMoves[i], undo);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread &thread : threads)
+		thread.join();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t total = 0;
+	for (int i = 0; i < rootMoves.size(); ++i)
+	{
+		if (divide)
+			std::printf("%s: %llu\n", rootMoves[i].uci().c_str(), (unsigned long long)counts[i]);
+		total += counts[i];
+	}
+	if (divide)
+		std::printf("\n");
+
+	std::printf("Nodes searched: %llu\n", (unsigned long long)total);
+	std::printf("Time: %.3f s\n", seconds);
+	std::printf("Nodes/second: %.0f\n", seconds > 0 ? total / seconds : 0.0);
+	return 0;
+}
@@ -0,0 +1,52 @@
+"""
+Moves handed in from Python as integers or rows and columns are checked before they reach
+the engine. Run from the repository root after building the module:
+
+    python -m unittest discover tests
+"""
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import chess  # noqa: E402
+
+
+class EncodedMoveTest(unittest.TestCase):
+    def test_unused_flag_is_rejected(self):
+        for flag in range(8, 16):
+            with self.assertRaises(ValueError):
+                chess.Move.from_int(flag << 12)
+
+    def test_known_flags_round_trip(self):
+        for move in chess.Board().get_legal_moves_encoded():
+            self.assertEqual(int(chess.Move.from_int(int(move))), int(move))
+
+    def test_make_move_encoded_rejects_bad_encoding(self):
+        board = chess.Board()
+        with self.assertRaises(ValueError):
+            board.make_move_encoded(0xC000)
+        self.assertEqual(board.get_ply(), 0)
+
+    def test_make_move_encoded_rejects_illegal_move(self):
+        board = chess.Board()
+        e2e5 = 52 | 28 << 6  # Three squares forward
+        with self.assertRaises(ValueError):
+            board.make_move_encoded(e2e5)
+        self.assertEqual(board.get_ply(), 0)
+
+    def test_make_move_encoded_plays_legal_move(self):
+        board = chess.Board()
+        board.make_move_encoded(int(board.get_legal_moves_encoded()[0]))
+        self.assertEqual(board.get_ply(), 1)
+
+    def test_constructor_rejects_off_board_and_bad_promotion(self):
+        with self.assertRaises(ValueError):
+            chess.Move(8, 0, 0, 0)
+        with self.assertRaises(ValueError):
+            chess.Move(1, 0, 0, 0, 7)
+        self.assertEqual(chess.Move(1, 0, 0, 0, 5).promotion_piece, 5)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,40 @@
+"""
+The get*Moves generators append to a chess.MoveList the caller owns, which has a fixed
+capacity. Run from the repository root after building the module:
+
+    python -m unittest discover tests
+"""
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import chess  # noqa: E402
+
+
+class MoveListTest(unittest.TestCase):
+    def test_generators_append(self):
+        board = chess.Board()
+        moves = chess.MoveList()
+        board.getKnightMoves(7, 1, moves)  # b1: a3, c3
+        board.getKnightMoves(7, 6, moves)  # g1: f3, h3
+        self.assertEqual(len(moves), 4)
+
+    def test_full_list_raises_instead_of_overflowing(self):
+        board = chess.Board()
+        moves = chess.MoveList()
+        with self.assertRaises(IndexError):
+            for _ in range(200):
+                board.getKnightMoves(7, 1, moves)
+        self.assertLessEqual(len(moves), 256)
+        moves.clear()
+        board.getKnightMoves(7, 1, moves)
+        self.assertEqual(len(moves), 2)
+
+    def test_square_off_the_board_raises(self):
+        with self.assertRaises(ValueError):
+            chess.Board().getPawnMoves(8, 0, chess.MoveList())
+
+
+if __name__ == "__main__":
+    unittest.main()